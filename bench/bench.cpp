@@ -0,0 +1,300 @@
+// Benchmarks of variant, optional and string_view
+// Vladimir Talybin (2021)
+//
+// Built twice by Makefile: with -std=c++14 to measure the backports and
+// with -std=c++17 to measure libstdc++ for comparison.
+//
+
+#include "variant.hpp"
+#include "optional.hpp"
+#include "string_view.hpp"
+#include "bench.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if __cplusplus < 201703L
+// Checks never fail here, abort if they do
+void ard::on_exception(const std::exception& ex)
+{ std::fprintf(stderr, "exception: %s\n", ex.what()); }
+#endif
+
+namespace
+{
+    struct point { int x, y; };
+
+    using var4 = std::variant<int, double, point, const char*>;
+    using var8 = std::variant<char, short, int, long, float, double, point, const char*>;
+
+    // Deterministic pseudo-random sequence
+    struct lcg {
+        uint32_t state = 12345;
+        uint32_t operator()()
+        { return state = state * 1664525u + 1013904223u; }
+    };
+
+    template <class Var>
+    std::vector<Var> make_variants(size_t n)
+    {
+        std::vector<Var> vec;
+        lcg rnd;
+        for (size_t i = 0; i < n; ++i) {
+            switch (rnd() % 4) {
+            case 0: vec.emplace_back(int(i)); break;
+            case 1: vec.emplace_back(double(i)); break;
+            case 2: vec.emplace_back(point{ int(i), 1 }); break;
+            case 3: vec.emplace_back("abc"); break;
+            }
+        }
+        return vec;
+    }
+
+    struct value_of {
+        long operator()(int v) const { return v; }
+        long operator()(double v) const { return long(v); }
+        long operator()(point p) const { return p.x + p.y; }
+        long operator()(const char* s) const { return *s; }
+        template <class T>
+        long operator()(T v) const { return long(v); }
+    };
+
+    struct pair_value {
+        template <class T, class U>
+        long operator()(const T& a, const U& b) const
+        { return value_of{}(a) - value_of{}(b); }
+    };
+
+    // Visit
+
+    void bench_visit()
+    {
+        auto v4 = make_variants<var4>(1024);
+        auto v8 = make_variants<var8>(1024);
+
+        bench::run("visit/4 alternatives", [&](size_t n) {
+            long sum = 0;
+            for (size_t i = 0; i < n; ++i)
+                sum += std::visit(value_of{}, v4[i & 1023]);
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("visit/8 alternatives", [&](size_t n) {
+            long sum = 0;
+            for (size_t i = 0; i < n; ++i)
+                sum += std::visit(value_of{}, v8[i & 1023]);
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("visit/2 variants", [&](size_t n) {
+            long sum = 0;
+            for (size_t i = 0; i < n; ++i)
+                sum += std::visit(pair_value{}, v4[i & 1023], v4[(i + 1) & 1023]);
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("get_if", [&](size_t n) {
+            long sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                if (auto p = std::get_if<int>(&v4[i & 1023]))
+                    sum += *p;
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    // Construction and assignment
+
+    void bench_construct()
+    {
+        auto src = make_variants<var4>(1024);
+
+        bench::run("variant/construct", [&](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                var4 v(src[i & 1023]);
+                bench::do_not_optimize(v);
+            }
+        });
+
+        bench::run("variant/copy assign", [&](size_t n) {
+            var4 v;
+            for (size_t i = 0; i < n; ++i) {
+                v = src[i & 1023];
+                bench::do_not_optimize(v);
+            }
+        });
+
+        bench::run("variant/converting assign", [&](size_t n) {
+            var4 v;
+            for (size_t i = 0; i < n; ++i) {
+                if (i & 1)
+                    v = int(i);
+                else
+                    v = double(i);
+                bench::do_not_optimize(v);
+            }
+        });
+
+        bench::run("variant/emplace", [&](size_t n) {
+            var4 v;
+            for (size_t i = 0; i < n; ++i) {
+                v.emplace<point>(point{ int(i), 2 });
+                bench::do_not_optimize(v);
+            }
+        });
+
+        bench::run("variant<string>/swap", [&](size_t n) {
+            std::variant<int, std::string> a(std::string("a long string, not in sso buffer"));
+            std::variant<int, std::string> b(5);
+            for (size_t i = 0; i < n; ++i) {
+                a.swap(b);
+                bench::do_not_optimize(a);
+            }
+        });
+    }
+
+    // Optional access
+
+    void bench_optional()
+    {
+        std::vector<std::optional<int>> vec(1024);
+        lcg rnd;
+        for (auto& o : vec) {
+            if (rnd() & 1)
+                o = int(rnd() & 0xff);
+        }
+
+        bench::run("optional/has_value", [&](size_t n) {
+            long sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                auto& o = vec[i & 1023];
+                if (o.has_value())
+                    sum += *o;
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("optional/value_or", [&](size_t n) {
+            long sum = 0;
+            for (size_t i = 0; i < n; ++i)
+                sum += vec[i & 1023].value_or(-1);
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("optional/assign", [&](size_t n) {
+            std::optional<int> o;
+            for (size_t i = 0; i < n; ++i) {
+                if (i & 1)
+                    o = int(i);
+                else
+                    o.reset();
+                bench::do_not_optimize(o);
+            }
+        });
+    }
+
+    // String view find
+
+    void bench_string_view()
+    {
+        std::string text;
+        lcg rnd;
+        while (text.size() < 4096)
+            text += char('a' + rnd() % 26);
+        text += "needle";
+        std::string_view sv(text.data(), text.size());
+
+        bench::run("string_view/find char", [&](size_t n) {
+            size_t sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                bench::clobber();
+                sum += sv.find('!');
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("string_view/find string", [&](size_t n) {
+            size_t sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                bench::clobber();
+                sum += sv.find("needle");
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("string_view/rfind char", [&](size_t n) {
+            size_t sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                bench::clobber();
+                sum += sv.rfind('!');
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("string_view/find_first_of", [&](size_t n) {
+            size_t sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                bench::clobber();
+                sum += sv.find_first_of("0123456789");
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("string_view/find_first_not_of", [&](size_t n) {
+            size_t sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                bench::clobber();
+                sum += sv.find_first_not_of("abcdefghijklmnopqrstuvwxyz");
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        std::vector<std::string> keys;
+        for (int i = 0; i < 1024; ++i)
+            keys.push_back("topic/device/" + std::to_string(i * 7919));
+        std::unordered_map<std::string_view, int> map;
+        for (auto& k : keys)
+            map.emplace(std::string_view(k.data(), k.size()), 1);
+
+        bench::run("string_view/hash", [&](size_t n) {
+            size_t sum = 0;
+            std::hash<std::string_view> hash;
+            for (size_t i = 0; i < n; ++i) {
+                auto& k = keys[i & 1023];
+                sum += hash(std::string_view(k.data(), k.size()));
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("unordered_map<string_view>/find", [&](size_t n) {
+            long sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                auto& k = keys[i & 1023];
+                sum += map.find(std::string_view(k.data(), k.size()))->second;
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("string_view/compare", [&](size_t n) {
+            std::string copy(text);
+            std::string_view other(copy.data(), copy.size());
+            int sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                bench::clobber();
+                sum += sv.compare(other);
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+}
+
+int main()
+{
+    std::printf("# C++%ld (%s)\n", (__cplusplus / 100) % 100,
+        __cplusplus >= 201703L ? "libstdc++" : "ard-stdlib");
+
+    bench_visit();
+    bench_construct();
+    bench_optional();
+    bench_string_view();
+}
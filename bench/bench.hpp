@@ -0,0 +1,42 @@
+// Minimal micro-benchmark harness
+// Vladimir Talybin (2021)
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+
+namespace bench
+{
+    // Keep value alive for optimizer
+    template <class T>
+    inline void do_not_optimize(const T& value)
+    { asm volatile("" : : "r,m"(value) : "memory"); }
+
+    inline void clobber()
+    { asm volatile("" : : : "memory"); }
+
+    // Run fn(iterations) until it takes at least min_ns, report ns/op
+    template <class Fn>
+    void run(const char* name, Fn fn)
+    {
+        using clock = std::chrono::steady_clock;
+        constexpr int64_t min_ns = 200 * 1000 * 1000;
+
+        size_t iters = 1000;
+        for (;;) {
+            auto start = clock::now();
+            fn(iters);
+            int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock::now() - start).count();
+
+            if (ns >= min_ns) {
+                std::printf("%-32s %10.3f ns/op\n", name, double(ns) / iters);
+                return;
+            }
+            iters *= ns > min_ns / 100 ? (min_ns / ns + 1) : 100;
+        }
+    }
+}
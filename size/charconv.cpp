@@ -0,0 +1,40 @@
+// Representative charconv instantiations for size accounting
+
+#include "charconv.hpp"
+
+int size_from_chars_int(const char* first, const char* last)
+{
+    int value = 0;
+    std::from_chars(first, last, value);
+    return value;
+}
+
+unsigned size_from_chars_hex(const char* first, const char* last)
+{
+    unsigned value = 0;
+    std::from_chars(first, last, value, 16);
+    return value;
+}
+
+float size_from_chars_float(const char* first, const char* last)
+{
+    float value = 0;
+    std::from_chars(first, last, value);
+    return value;
+}
+
+double size_from_chars_double(const char* first, const char* last)
+{
+    double value = 0;
+    std::from_chars(first, last, value);
+    return value;
+}
+
+char* size_to_chars_int(char* first, char* last, int value)
+{ return std::to_chars(first, last, value).ptr; }
+
+char* size_to_chars_float(char* first, char* last, float value)
+{ return std::to_chars(first, last, value).ptr; }
+
+char* size_to_chars_double(char* first, char* last, double value)
+{ return std::to_chars(first, last, value).ptr; }
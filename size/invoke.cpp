@@ -0,0 +1,17 @@
+// Representative invoke instantiations for size accounting
+
+#include "functional.hpp"
+
+struct counter {
+    int n;
+    int add(int x) { return n += x; }
+};
+
+int size_invoke_function(int (*fn)(int), int x)
+{ return std::invoke(fn, x); }
+
+int size_invoke_member_function(counter& c, int x)
+{ return std::invoke(&counter::add, c, x); }
+
+int size_invoke_member_data(const counter* c)
+{ return std::invoke(&counter::n, c); }
@@ -0,0 +1,20 @@
+// Representative optional instantiations for size accounting
+
+#include "optional.hpp"
+
+struct point { int x, y; };
+
+int size_optional_value(const std::optional<int>& o)
+{ return o.value(); }
+
+int size_optional_value_or(const std::optional<int>& o)
+{ return o.value_or(-1); }
+
+void size_optional_assign(std::optional<point>& o, int x)
+{ o = point{ x, x }; }
+
+void size_optional_reset(std::optional<point>& o)
+{ o.reset(); }
+
+bool size_optional_compare(const std::optional<int>& a, const std::optional<int>& b)
+{ return a < b; }
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+#
+# Size and stack usage report of objects built by Makefile
+# Vladimir Talybin (2021)
+#
+# Usage:
+#   report.py OBJDUMP TOOLCHAIN obj...       print report
+#   report.py --diff OLD NEW                 print changed figures
+#
+# Each report line is "<bytes> <kind> <unit>: <symbol>", where kind is
+# text, rodata, data, bss or stack. Objects are built with
+# -ffunction-sections -fdata-sections, so every symbol has its own
+# section and text/rodata figures are taken from section sizes.
+#
+
+import os
+import subprocess
+import sys
+
+KINDS = ('text', 'rodata', 'data', 'bss')
+
+# Section prefix to kind, first match wins
+PREFIXES = (
+    ('.text', 'text'),
+    ('.rodata', 'rodata'),
+    ('.data.rel.ro', 'rodata'),  # vtables, in flash on target
+    ('.data', 'data'),
+    ('.bss', 'bss'),
+)
+
+
+def section_kind(section):
+    """Return (kind, symbol) of section, symbol is mangled"""
+    for prefix, kind in PREFIXES:
+        if section == prefix:
+            return kind, ''
+        if section.startswith(prefix + '.'):
+            rest = section[len(prefix) + 1:]
+            if rest.startswith('local.'):
+                rest = rest[len('local.'):]
+            # Strip clone and string pool suffixes (.isra.0, .str1.1)
+            name = rest.split('.')[0]
+            if '.str' in rest:
+                name += ' [strings]'
+            return kind, name
+    return None, None
+
+
+def demangle(names):
+    if not names:
+        return {}
+    out = subprocess.run(['c++filt'], input='\n'.join(names), check=True,
+                         stdout=subprocess.PIPE, universal_newlines=True).stdout
+    return dict(zip(names, out.splitlines()))
+
+
+def sections(objdump, obj):
+    """Return {(kind, symbol): bytes} of allocated sections"""
+    out = subprocess.run([objdump, '-h', '-w', obj], check=True,
+                         stdout=subprocess.PIPE, universal_newlines=True).stdout
+    sizes = {}
+    for line in out.splitlines():
+        parts = line.split()
+        # Idx Name Size VMA LMA File-off Algn Flags
+        if len(parts) < 8 or not parts[0].isdigit():
+            continue
+        kind, name = section_kind(parts[1])
+        size = int(parts[2], 16)
+        if kind and size:
+            key = (kind, name or '(unnamed)')
+            sizes[key] = sizes.get(key, 0) + size
+
+    names = demangle(sorted(set(n.split(' ')[0] for _, n in sizes)))
+    result = {}
+    for (kind, name), size in sizes.items():
+        base, _, tag = name.partition(' ')
+        pretty = names.get(base, base) + (' ' + tag if tag else '')
+        result[(kind, pretty)] = result.get((kind, pretty), 0) + size
+    return result
+
+
+def stack(obj):
+    """Yield (bytes, function) from .su file next to object"""
+    su = os.path.splitext(obj)[0] + '.su'
+    if not os.path.exists(su):
+        return
+    with open(su) as f:
+        for line in f:
+            loc, size, _ = line.rstrip('\n').split('\t')
+            # file:line:col:function
+            yield int(size), loc.split(':', 3)[3]
+
+
+def report(objdump, toolchain, objs):
+    print('# toolchain: ' + toolchain)
+    for obj in objs:
+        unit = os.path.splitext(os.path.basename(obj))[0]
+        totals = dict.fromkeys(KINDS, 0)
+        figures = sections(objdump, obj)
+        for kind, name in sorted(figures, key=lambda k: (KINDS.index(k[0]), k[1])):
+            totals[kind] += figures[(kind, name)]
+            print('%8d %-6s %s: %s' % (figures[(kind, name)], kind, unit, name))
+        for size, name in sorted(stack(obj), key=lambda s: s[1]):
+            print('%8d %-6s %s: %s' % (size, 'stack', unit, name))
+        for kind in KINDS:
+            print('%8d %-6s %s: TOTAL' % (totals[kind], kind, unit))
+
+
+def load(path):
+    figures = {}
+    with open(path) as f:
+        for line in f:
+            if line.startswith('#') or not line.strip():
+                continue
+            size, kind, rest = line.split(None, 2)
+            figures[(kind, rest.rstrip('\n'))] = int(size)
+    return figures
+
+
+def diff(old_path, new_path):
+    old, new = load(old_path), load(new_path)
+    changed = False
+    print('%8s %8s %8s' % ('old', 'new', 'delta'))
+    for key in sorted(set(old) | set(new), key=lambda k: (k[1], k[0])):
+        a, b = old.get(key, 0), new.get(key, 0)
+        if a != b:
+            changed = True
+            print('%8d %8d %+8d %-6s %s' % (a, b, b - a, key[0], key[1]))
+    if not changed:
+        print('no change')
+
+
+def main(argv):
+    if len(argv) == 4 and argv[1] == '--diff':
+        diff(argv[2], argv[3])
+    elif len(argv) >= 4:
+        report(argv[1], argv[2], argv[3:])
+    else:
+        sys.stderr.write(__doc__ if __doc__ else 'bad arguments\n')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
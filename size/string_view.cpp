@@ -0,0 +1,27 @@
+// Representative string_view instantiations for size accounting
+
+#include "string_view.hpp"
+
+char size_string_view_at(std::string_view sv, size_t pos)
+{ return sv.at(pos); }
+
+char size_string_view_front_back(std::string_view sv)
+{ return sv.front() + sv.back(); }
+
+size_t size_string_view_find_char(std::string_view sv, char c)
+{ return sv.find(c); }
+
+size_t size_string_view_find(std::string_view sv, std::string_view s)
+{ return sv.find(s); }
+
+size_t size_string_view_find_first_of(std::string_view sv, std::string_view s)
+{ return sv.find_first_of(s); }
+
+int size_string_view_compare(std::string_view a, std::string_view b)
+{ return a.compare(b); }
+
+std::string_view size_string_view_substr(std::string_view sv, size_t pos, size_t n)
+{ return sv.substr(pos, n); }
+
+size_t size_string_view_hash(std::string_view sv)
+{ return std::hash<std::string_view>{}(sv); }
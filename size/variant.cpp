@@ -0,0 +1,39 @@
+// Representative variant instantiations for size accounting
+
+#include "variant.hpp"
+
+struct point { int x, y; };
+
+using var3 = std::variant<int, float, point>;
+using var8 = std::variant<char, short, int, long, float, double, point, const char*>;
+
+struct value_of {
+    int operator()(point p) const { return p.x + p.y; }
+    int operator()(const char* s) const { return *s; }
+    template <class T>
+    int operator()(T v) const { return int(v); }
+};
+
+int size_variant_visit3(const var3& v)
+{ return std::visit(value_of{}, v); }
+
+int size_variant_visit8(const var8& v)
+{ return std::visit(value_of{}, v); }
+
+int size_variant_visit2x3(const var3& a, const var3& b)
+{ return std::visit([](auto x, auto y) { return value_of{}(x) - value_of{}(y); }, a, b); }
+
+int size_variant_get(const var3& v)
+{ return std::get<int>(v); }
+
+const float* size_variant_get_if(const var3& v)
+{ return std::get_if<float>(&v); }
+
+void size_variant_copy_assign(var3& dst, const var3& src)
+{ dst = src; }
+
+void size_variant_emplace(var3& v, int x, int y)
+{ v.emplace<point>(point{ x, y }); }
+
+void size_variant_swap(var8& a, var8& b)
+{ a.swap(b); }
@@ -0,0 +1,15 @@
+#pragma once
+#include <algorithm>
+
+#if __cplusplus < 201703L
+namespace std
+{
+    /// \see https://en.cppreference.com/w/cpp/algorithm/search
+    template <class _ForwardIterator, class _Searcher>
+    inline _ForwardIterator
+    search(_ForwardIterator __first, _ForwardIterator __last,
+           const _Searcher& __searcher)
+    { return __searcher(__first, __last).first; }
+
+} // namespace std
+#endif // __cplusplus < 201703L
@@ -0,0 +1,74 @@
+// Set of chars for string_view searches
+// Vladimir Talybin (2021)
+//
+// File version: 1.0.0
+//
+// Lookup table of 256 bits accepted by find_first_of(), find_last_of(),
+// find_first_not_of() and find_last_not_of() of std::string_view. Test of
+// a char is a single bit lookup, regardless of number of chars in set.
+// May be built at compile time:
+//
+//   constexpr ard::char_set delims(" \t\r\n");
+//   size_t pos = line.find_first_of(delims);
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace ard
+{
+    struct char_set
+    {
+    private:
+        uint32_t bits_[8];
+
+    public:
+        constexpr char_set() noexcept
+        : bits_{}
+        { }
+
+        constexpr char_set(const char* str, size_t n) noexcept
+        : bits_{}
+        {
+            for (size_t i = 0; i < n; ++i)
+                insert(str[i]);
+        }
+
+        constexpr explicit char_set(const char* str) noexcept
+        : bits_{}
+        {
+            for (; *str; ++str)
+                insert(*str);
+        }
+
+        // Any string type providing data() and size()
+        template <class S, class = decltype(
+            std::declval<const S&>().data(), std::declval<const S&>().size())>
+        constexpr explicit char_set(const S& str) noexcept
+        : char_set(str.data(), str.size())
+        { }
+
+        constexpr char_set& insert(char c) noexcept {
+            const unsigned char u = static_cast<unsigned char>(c);
+            bits_[u >> 5] |= uint32_t(1) << (u & 31);
+            return *this;
+        }
+
+        constexpr bool test(char c) const noexcept {
+            const unsigned char u = static_cast<unsigned char>(c);
+            return (bits_[u >> 5] >> (u & 31)) & 1;
+        }
+
+        // Set of all chars not in this set
+        constexpr char_set operator~() const noexcept {
+            char_set ret;
+            for (size_t i = 0; i < 8; ++i)
+                ret.bits_[i] = ~bits_[i];
+            return ret;
+        }
+    };
+
+} // namespace ard
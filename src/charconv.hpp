@@ -0,0 +1,1299 @@
+// Primitive numeric conversions
+// Vladimir Talybin (2021)
+//
+// File version: 1.0.0
+//
+// Features:
+//  - from_chars() of C++17 for integers and floating point, parses
+//    [first, last) without copying, heap, locale or errno
+//  - Base 10 integers take a loop without overflow checks for as many
+//    digits as always fit in the type
+//  - Decimal floats with up to 15 significant digits and small exponent
+//    (most of real input) are converted exactly with a single multiply
+//    or divide (Clinger's fast path). Others go through 64-bit
+//    arithmetic with cached powers of ten, and only values close to
+//    halfway between two floats are decided by exact big integer
+//    comparison with all digits of input. Decimal input of any length and
+//    hex floats are always correctly rounded.
+//  - long double is parsed with precision and range of double
+//  - to_chars() of C++17 for integers and floating point. Floats are
+//    written in the shortest form that reads back to the same value,
+//    closest to it of all such, with the same output as libstdc++.
+//    Digits come from 64-bit arithmetic (Grisu3), or from exact big
+//    integer arithmetic in about 1 of 200 cases where that is not certain.
+//    Overloads with precision are not provided.
+//  - ard::from_chars() of string_view and other strings
+//
+// In C++17 mode <charconv> of standard library is used (floating point
+// from_chars and to_chars are available since GCC 11). The core of
+// float to_chars is ard::detail::float_to_chars() in all modes.
+//
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace ard
+{
+    namespace detail
+    {
+        // Floating point number f * 2^e with 64-bit mantissa
+        struct diy_fp {
+            uint64_t f;
+            int e;
+        };
+
+        // Product rounded to 64 bits, with 32-bit multiplies only
+        inline diy_fp multiply(diy_fp x, diy_fp y) noexcept
+        {
+            const uint64_t mask = 0xffffffff;
+            const uint64_t a = x.f >> 32, b = x.f & mask;
+            const uint64_t c = y.f >> 32, d = y.f & mask;
+            const uint64_t ac = a * c, bc = b * c;
+            const uint64_t ad = a * d, bd = b * d;
+            const uint64_t mid = (bd >> 32) + (ad & mask)
+                + (bc & mask) + (1u << 31);
+            return { ac + (ad >> 32) + (bc >> 32) + (mid >> 32),
+                x.e + y.e + 64 };
+        }
+
+        // Normalized 10^k, k = -348 + 8 * i, rounded to 64 bits
+        inline diy_fp cached_power(int i) noexcept
+        {
+            static const diy_fp table[] = {
+                { 0xfa8fd5a0081c0288ull, -1220 }, { 0xbaaee17fa23ebf76ull, -1193 },
+                { 0x8b16fb203055ac76ull, -1166 }, { 0xcf42894a5dce35eaull, -1140 },
+                { 0x9a6bb0aa55653b2dull, -1113 }, { 0xe61acf033d1a45dfull, -1087 },
+                { 0xab70fe17c79ac6caull, -1060 }, { 0xff77b1fcbebcdc4full, -1034 },
+                { 0xbe5691ef416bd60cull, -1007 }, { 0x8dd01fad907ffc3cull,  -980 },
+                { 0xd3515c2831559a83ull,  -954 }, { 0x9d71ac8fada6c9b5ull,  -927 },
+                { 0xea9c227723ee8bcbull,  -901 }, { 0xaecc49914078536dull,  -874 },
+                { 0x823c12795db6ce57ull,  -847 }, { 0xc21094364dfb5637ull,  -821 },
+                { 0x9096ea6f3848984full,  -794 }, { 0xd77485cb25823ac7ull,  -768 },
+                { 0xa086cfcd97bf97f4ull,  -741 }, { 0xef340a98172aace5ull,  -715 },
+                { 0xb23867fb2a35b28eull,  -688 }, { 0x84c8d4dfd2c63f3bull,  -661 },
+                { 0xc5dd44271ad3cdbaull,  -635 }, { 0x936b9fcebb25c996ull,  -608 },
+                { 0xdbac6c247d62a584ull,  -582 }, { 0xa3ab66580d5fdaf6ull,  -555 },
+                { 0xf3e2f893dec3f126ull,  -529 }, { 0xb5b5ada8aaff80b8ull,  -502 },
+                { 0x87625f056c7c4a8bull,  -475 }, { 0xc9bcff6034c13053ull,  -449 },
+                { 0x964e858c91ba2655ull,  -422 }, { 0xdff9772470297ebdull,  -396 },
+                { 0xa6dfbd9fb8e5b88full,  -369 }, { 0xf8a95fcf88747d94ull,  -343 },
+                { 0xb94470938fa89bcfull,  -316 }, { 0x8a08f0f8bf0f156bull,  -289 },
+                { 0xcdb02555653131b6ull,  -263 }, { 0x993fe2c6d07b7facull,  -236 },
+                { 0xe45c10c42a2b3b06ull,  -210 }, { 0xaa242499697392d3ull,  -183 },
+                { 0xfd87b5f28300ca0eull,  -157 }, { 0xbce5086492111aebull,  -130 },
+                { 0x8cbccc096f5088ccull,  -103 }, { 0xd1b71758e219652cull,   -77 },
+                { 0x9c40000000000000ull,   -50 }, { 0xe8d4a51000000000ull,   -24 },
+                { 0xad78ebc5ac620000ull,     3 }, { 0x813f3978f8940984ull,    30 },
+                { 0xc097ce7bc90715b3ull,    56 }, { 0x8f7e32ce7bea5c70ull,    83 },
+                { 0xd5d238a4abe98068ull,   109 }, { 0x9f4f2726179a2245ull,   136 },
+                { 0xed63a231d4c4fb27ull,   162 }, { 0xb0de65388cc8ada8ull,   189 },
+                { 0x83c7088e1aab65dbull,   216 }, { 0xc45d1df942711d9aull,   242 },
+                { 0x924d692ca61be758ull,   269 }, { 0xda01ee641a708deaull,   295 },
+                { 0xa26da3999aef774aull,   322 }, { 0xf209787bb47d6b85ull,   348 },
+                { 0xb454e4a179dd1877ull,   375 }, { 0x865b86925b9bc5c2ull,   402 },
+                { 0xc83553c5c8965d3dull,   428 }, { 0x952ab45cfa97a0b3ull,   455 },
+                { 0xde469fbd99a05fe3ull,   481 }, { 0xa59bc234db398c25ull,   508 },
+                { 0xf6c69a72a3989f5cull,   534 }, { 0xb7dcbf5354e9beceull,   561 },
+                { 0x88fcf317f22241e2ull,   588 }, { 0xcc20ce9bd35c78a5ull,   614 },
+                { 0x98165af37b2153dfull,   641 }, { 0xe2a0b5dc971f303aull,   667 },
+                { 0xa8d9d1535ce3b396ull,   694 }, { 0xfb9b7cd9a4a7443cull,   720 },
+                { 0xbb764c4ca7a44410ull,   747 }, { 0x8bab8eefb6409c1aull,   774 },
+                { 0xd01fef10a657842cull,   800 }, { 0x9b10a4e5e9913129ull,   827 },
+                { 0xe7109bfba19c0c9dull,   853 }, { 0xac2820d9623bf429ull,   880 },
+                { 0x80444b5e7aa7cf85ull,   907 }, { 0xbf21e44003acdd2dull,   933 },
+                { 0x8e679c2f5e44ff8full,   960 }, { 0xd433179d9c8cb841ull,   986 },
+                { 0x9e19db92b4e31ba9ull,  1013 }, { 0xeb96bf6ebadf77d9ull,  1039 },
+                { 0xaf87023b9bf0ee6bull,  1066 }
+            };
+            return table[i];
+        }
+
+        constexpr int cached_power_min_exp10 = -348;
+        constexpr int cached_power_step = 8;
+
+        // Unsigned integer of up to 32 * N bits, for exact decisions where
+        // 64-bit arithmetic is not enough
+        template <int N>
+        struct bigint {
+            uint32_t w[N];
+            int n = 0;
+
+            explicit bigint(uint64_t v = 0) noexcept {
+                for (; v; v >>= 32)
+                    w[n++] = uint32_t(v);
+            }
+
+            void mul_add(uint32_t m, uint32_t a = 0) noexcept {
+                uint64_t carry = a;
+                for (int i = 0; i < n; ++i) {
+                    const uint64_t t = uint64_t(w[i]) * m + carry;
+                    w[i] = uint32_t(t);
+                    carry = t >> 32;
+                }
+                if (carry)
+                    w[n++] = uint32_t(carry);
+            }
+
+            void mul_pow5(int k) noexcept {
+                static const uint32_t table[] = {
+                    1, 5, 25, 125, 625, 3125, 15625, 78125, 390625,
+                    1953125, 9765625, 48828125, 244140625
+                };
+                for (; k >= 13; k -= 13)
+                    mul_add(1220703125);
+                if (k)
+                    mul_add(table[k]);
+            }
+
+            void mul_pow10(int k) noexcept {
+                mul_pow5(k);
+                shift_left(k);
+            }
+
+            void shift_left(int k) noexcept {
+                if (n == 0)
+                    return;
+                if (const int bits = k % 32) {
+                    uint32_t carry = 0;
+                    for (int i = 0; i < n; ++i) {
+                        const uint32_t t = w[i];
+                        w[i] = (t << bits) | carry;
+                        carry = t >> (32 - bits);
+                    }
+                    if (carry)
+                        w[n++] = carry;
+                }
+                if (const int words = k / 32) {
+                    std::memmove(w + words, w, n * sizeof(uint32_t));
+                    std::memset(w, 0, words * sizeof(uint32_t));
+                    n += words;
+                }
+            }
+
+            void add(const bigint& y) noexcept {
+                const int m = n > y.n ? n : y.n;
+                uint64_t carry = 0;
+                for (int i = 0; i < m; ++i) {
+                    const uint64_t t = uint64_t(i < n ? w[i] : 0)
+                        + (i < y.n ? y.w[i] : 0) + carry;
+                    w[i] = uint32_t(t);
+                    carry = t >> 32;
+                }
+                n = m;
+                if (carry)
+                    w[n++] = uint32_t(carry);
+            }
+
+            // Divide by d, returns remainder
+            uint32_t div_small(uint32_t d) noexcept {
+                uint64_t rem = 0;
+                for (int i = n - 1; i >= 0; --i) {
+                    const uint64_t t = (rem << 32) | w[i];
+                    w[i] = uint32_t(t / d);
+                    rem = t % d;
+                }
+                while (n && !w[n - 1])
+                    --n;
+                return uint32_t(rem);
+            }
+
+            // y must not be greater
+            void sub(const bigint& y) noexcept {
+                uint64_t borrow = 0;
+                for (int i = 0; i < n; ++i) {
+                    const uint64_t t = uint64_t(w[i])
+                        - (i < y.n ? y.w[i] : 0) - borrow;
+                    w[i] = uint32_t(t);
+                    borrow = t >> 63;
+                }
+                while (n && !w[n - 1])
+                    --n;
+            }
+
+            friend int compare(const bigint& x, const bigint& y) noexcept {
+                if (x.n != y.n)
+                    return x.n < y.n ? -1 : 1;
+                for (int i = x.n - 1; i >= 0; --i) {
+                    if (x.w[i] != y.w[i])
+                        return x.w[i] < y.w[i] ? -1 : 1;
+                }
+                return 0;
+            }
+        };
+
+        // Move last digit of buf towards w (at dist below top of interval
+        // of width delta) while it stays inside. Values are only known
+        // within unit, fails if the result may not be the closest to w or
+        // may be outside of interval.
+        inline bool grisu3_round(char* buf, int len, uint64_t dist, uint64_t delta,
+            uint64_t rest, uint64_t ten_k, uint64_t unit) noexcept
+        {
+            const uint64_t small = dist - unit;
+            const uint64_t big = dist + unit;
+            while (rest < small && delta - rest >= ten_k
+                    && (rest + ten_k < small || small - rest >= rest + ten_k - small)) {
+                --buf[len - 1];
+                rest += ten_k;
+            }
+            if (rest < big && delta - rest >= ten_k
+                    && (rest + ten_k < big || big - rest > rest + ten_k - big))
+                return false;
+            return 2 * unit <= rest && rest <= delta - 4 * unit;
+        }
+
+        // Digits of the shortest number in (lo, hi) that is closest to w
+        // (Grisu3), all scaled by 2^e, -60 <= e <= -32, and off by up to 1.
+        // Adds their scale to exp10. Fails in rare cases where this is not
+        // enough to be certain.
+        inline bool grisu3_digits(char* buf, int& len, int& exp10, uint64_t lo,
+            uint64_t w, uint64_t hi, int e) noexcept
+        {
+            const int shift = -e;
+            const uint64_t one = uint64_t(1) << shift;
+            uint64_t unit = 1;
+            // Interval widened by error, shortest digits are looked for in
+            // there and then checked to be inside of (lo, hi)
+            const uint64_t top = hi + unit;
+            uint64_t delta = top - (lo - unit);
+            const uint64_t dist = top - w;
+
+            // Integral part fits in 32 bits
+            uint32_t p1 = uint32_t(top >> shift);
+            uint64_t p2 = top & (one - 1);
+
+            uint32_t pow10 = 1;
+            int n = 1;
+            for (; p1 / 10 >= pow10; ++n)
+                pow10 *= 10;
+
+            len = 0;
+            while (n > 0) {
+                buf[len++] = char('0' + p1 / pow10);
+                p1 %= pow10;
+                --n;
+                const uint64_t rest = (uint64_t(p1) << shift) + p2;
+                if (rest < delta) {
+                    exp10 += n;
+                    return grisu3_round(buf, len, dist, delta, rest,
+                        uint64_t(pow10) << shift, unit);
+                }
+                pow10 /= 10;
+            }
+
+            // Fractional part
+            for (;;) {
+                p2 *= 10;
+                unit *= 10;
+                delta *= 10;
+                buf[len++] = char('0' + (p2 >> shift));
+                p2 &= one - 1;
+                --exp10;
+                if (p2 < delta)
+                    return grisu3_round(buf, len, dist * unit, delta, p2, one, unit);
+            }
+        }
+
+        // Digits of the shortest number between halfway points to
+        // neighbors of f * 2^e that is closest to it, by exact arithmetic
+        // (Steele and White). Halfway points are included if f is even,
+        // ties are rounded to even digit, same as Ryu of libstdc++.
+        __attribute__((noinline)) inline int exact_digits(uint64_t f, int e,
+            bool lower_closer, char* buf, int& exp10) noexcept
+        {
+            using big = bigint<40>;
+            const bool even = (f & 1) == 0;
+            const int lc = lower_closer;
+
+            // Value is r / s, distances to halfway points are m_plus / s
+            // and m_minus / s
+            big r(f), s(1), m_plus(1), m_minus(1);
+            if (e >= 0) {
+                r.shift_left(e + 1 + lc);
+                s.shift_left(1 + lc);
+                m_plus.shift_left(e + lc);
+                m_minus.shift_left(e);
+            }
+            else {
+                r.shift_left(1 + lc);
+                s.shift_left(1 - e + lc);
+                m_plus.shift_left(lc);
+            }
+
+            // Scale value to [0.1, 2), one up if upper halfway reaches 1
+            const int x = e + 63 - __builtin_clzll(f);
+            int k = int(std::ceil(x * 0.30102999566398114));
+            if (k >= 0)
+                s.mul_pow10(k);
+            else {
+                r.mul_pow10(-k);
+                m_plus.mul_pow10(-k);
+                m_minus.mul_pow10(-k);
+            }
+            big t = r;
+            t.add(m_plus);
+            int c = compare(t, s);
+            if (c > 0 || (c == 0 && even))
+                ++k;
+            else {
+                r.mul_add(10);
+                m_plus.mul_add(10);
+                m_minus.mul_add(10);
+            }
+
+            // Digits until value is within distance to a halfway point
+            int len = 0;
+            for (;;) {
+                int digit = 0;
+                while (compare(r, s) >= 0) {
+                    r.sub(s);
+                    ++digit;
+                }
+                buf[len++] = char('0' + digit);
+
+                c = compare(r, m_minus);
+                const bool low = c < 0 || (c == 0 && even);
+                t = r;
+                t.add(m_plus);
+                c = compare(t, s);
+                const bool high = c > 0 || (c == 0 && even);
+                if (low && high) {
+                    t = r;
+                    t.shift_left(1);
+                    c = compare(t, s);
+                    if (c > 0 || (c == 0 && (digit & 1)))
+                        ++buf[len - 1];
+                    break;
+                }
+                if (low || high) {
+                    buf[len - 1] += high;
+                    break;
+                }
+                r.mul_add(10);
+                m_plus.mul_add(10);
+                m_minus.mul_add(10);
+            }
+            exp10 = k - len;
+            return len;
+        }
+
+        template <class T>
+        using float_bits_t = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+
+        // Shortest digits of positive finite value that are closest to it,
+        // value is digits * 10^exp10. Writes up to 17 digits. Grisu3 finds
+        // them for all but about 0.5% of doubles (1% of floats), which take
+        // the exact way.
+        template <class T>
+        int shortest_digits(T value, char* buf, int& exp10) noexcept
+        {
+            constexpr int digits = std::numeric_limits<T>::digits;
+            constexpr int bias = std::numeric_limits<T>::max_exponent - 2 + digits;
+            constexpr uint64_t hidden = uint64_t(1) << (digits - 1);
+
+            float_bits_t<T> bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            const uint64_t fraction = bits & (hidden - 1);
+            const int exp = int(bits >> (digits - 1));
+
+            const diy_fp x = exp ? diy_fp{ fraction + hidden, exp - bias }
+                : diy_fp{ fraction, 1 - bias };
+
+            // Halfway to neighbors, lower one is closer at powers of two
+            const bool lower_closer = fraction == 0 && exp > 1;
+            diy_fp hi = { 2 * x.f + 1, x.e - 1 };
+            diy_fp lo = lower_closer
+                ? diy_fp{ 4 * x.f - 1, x.e - 2 } : diy_fp{ 2 * x.f - 1, x.e - 1 };
+
+            const int hz = __builtin_clzll(hi.f);
+            hi.f <<= hz;
+            hi.e -= hz;
+            lo.f <<= lo.e - hi.e;
+            lo.e = hi.e;
+            diy_fp v = x;
+            const int vz = __builtin_clzll(v.f);
+            v.f <<= vz;
+            v.e -= vz;
+
+            // Cached power that brings exponent of hi into [-60, -32]
+            const int f = -60 - hi.e - 1;
+            const int k = (f * 78913) / (1 << 18) + (f > 0);
+            const int i = (k - cached_power_min_exp10 + cached_power_step - 1)
+                / cached_power_step;
+            const diy_fp c = cached_power(i);
+            exp10 = -(cached_power_min_exp10 + i * cached_power_step);
+
+            const diy_fp w = multiply(v, c);
+            const diy_fp wl = multiply(lo, c);
+            const diy_fp wh = multiply(hi, c);
+            int len;
+            if (grisu3_digits(buf, len, exp10, wl.f, w.f, wh.f, wh.e))
+                return len;
+            return exact_digits(x.f, x.e, lower_closer, buf, exp10);
+        }
+
+        // Value >= 2^digits of T, which is an integer, with all its
+        // digits. Returns end of output, or null if it does not fit. Kept
+        // out of line with its buffers.
+        template <class T>
+        __attribute__((noinline)) char* integer_to_chars(char* first, char* last,
+            T value) noexcept
+        {
+            constexpr int digits = std::numeric_limits<T>::digits;
+            constexpr int bias = std::numeric_limits<T>::max_exponent - 2 + digits;
+            constexpr uint64_t hidden = uint64_t(1) << (digits - 1);
+
+            float_bits_t<T> bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            bigint<40> b((bits & (hidden - 1)) | hidden);
+            b.shift_left(int(bits >> (digits - 1)) - bias);
+
+            // Nine digits at a time from the end
+            char buf[315];
+            char* const end = buf + sizeof(buf);
+            char* p = end;
+            while (b.n) {
+                uint32_t r = b.div_small(1000000000);
+                for (int i = 0; i < 9; ++i, r /= 10)
+                    *--p = char('0' + r % 10);
+            }
+            while (*p == '0')
+                ++p;
+            if (last - first < end - p)
+                return nullptr;
+            std::memcpy(first, p, end - p);
+            return first + (end - p);
+        }
+
+        // Write exponent with sign and at least min_digits digits
+        inline char* write_exp(char* p, char c, int exp, int min_digits) noexcept
+        {
+            *p++ = c;
+            *p++ = exp < 0 ? '-' : '+';
+            if (exp < 0)
+                exp = -exp;
+            if (exp >= 1000 || min_digits > 3)
+                *p++ = char('0' + exp / 1000);
+            if (exp >= 100 || min_digits > 2)
+                *p++ = char('0' + exp / 100 % 10);
+            if (exp >= 10 || min_digits > 1)
+                *p++ = char('0' + exp / 10 % 10);
+            *p++ = char('0' + exp % 10);
+            return p;
+        }
+
+        // Hexadecimal without 0x prefix and with exponent of 2, shortest.
+        // Writes up to 22 chars.
+        template <class T>
+        char* write_hex(char* p, T value) noexcept
+        {
+            constexpr int digits = std::numeric_limits<T>::digits;
+            constexpr int max_exp = std::numeric_limits<T>::max_exponent - 1;
+            // Fraction is padded to whole hex digits
+            constexpr int nibbles = (digits + 2) / 4;
+
+            float_bits_t<T> bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            uint64_t fraction = bits & ((uint64_t(1) << (digits - 1)) - 1);
+            int exp = int(bits >> (digits - 1));
+
+            *p++ = char('0' + (exp != 0));
+            if (fraction) {
+                fraction <<= nibbles * 4 - (digits - 1);
+                *p++ = '.';
+                for (int i = nibbles - 1; i >= 0 && fraction; --i) {
+                    *p++ = "0123456789abcdef"[fraction >> (i * 4) & 0xf];
+                    fraction &= (uint64_t(1) << (i * 4)) - 1;
+                }
+            }
+            exp = bits == 0 ? 0 : (exp ? exp : 1) - max_exp;
+            return write_exp(p, 'p', exp, 1);
+        }
+
+        // Shortest representation of value (as to_chars), fmt is a value
+        // of chars_format or 0 if not given. General notation is fixed for
+        // decimal exponents from -4 to 5, as %g. Returns end of output, or
+        // null if it does not fit.
+        template <class T>
+        char* float_to_chars(char* first, char* last, T value, unsigned fmt) noexcept
+        {
+            enum : unsigned { scientific = 1, fixed = 2, hex = 4, general = 3 };
+
+            char buf[32];
+            char* p = buf;
+            if (std::signbit(value)) {
+                *p++ = '-';
+                value = -value;
+            }
+
+            if (value != value) {
+                std::memcpy(p, "nan", 3);
+                p += 3;
+            }
+            else if (value > std::numeric_limits<T>::max()) {
+                std::memcpy(p, "inf", 3);
+                p += 3;
+            }
+            else if (fmt == hex)
+                p = write_hex(p, value);
+            else {
+                char digits[20];
+                int exp10 = 0;
+                int n = 1;
+                if (value == 0)
+                    digits[0] = '0';
+                else
+                    n = shortest_digits(value, digits, exp10);
+
+                // Exponent of scientific notation
+                const int x = n - 1 + exp10;
+                const int sci_len = n + (n > 1) + (x <= -100 || x >= 100 ? 5 : 4);
+                const int fixed_len = exp10 >= 0 ? n + exp10
+                    : x >= 0 ? n + 1 : 2 - exp10;
+
+                bool use_fixed;
+                if (fmt == fixed)
+                    use_fixed = true;
+                else if (fmt == scientific)
+                    use_fixed = false;
+                else if (fmt == general)
+                    use_fixed = x >= -4 && x < 6;
+                else
+                    use_fixed = fixed_len <= sci_len;
+
+                // Fixed notation may be long, write it in place. Large
+                // values are written with all their digits (as libstdc++),
+                // not shortest ones padded with zeros.
+                if (use_fixed) {
+                    if (exp10 > 0 && value >= T(uint64_t(1) << std::numeric_limits<T>::digits)) {
+                        if (last - first < p - buf)
+                            return nullptr;
+                        std::memcpy(first, buf, p - buf);
+                        return integer_to_chars(first + (p - buf), last, value);
+                    }
+                    const int len = int(p - buf) + fixed_len;
+                    if (last - first < len)
+                        return nullptr;
+                    std::memcpy(first, buf, p - buf);
+                    char* out = first + (p - buf);
+                    if (exp10 >= 0) {
+                        std::memcpy(out, digits, n);
+                        std::memset(out + n, '0', exp10);
+                    }
+                    else if (x >= 0) {
+                        std::memcpy(out, digits, x + 1);
+                        out[x + 1] = '.';
+                        std::memcpy(out + x + 2, digits + x + 1, n - x - 1);
+                    }
+                    else {
+                        out[0] = '0';
+                        out[1] = '.';
+                        std::memset(out + 2, '0', -x - 1);
+                        std::memcpy(out + 1 - x, digits, n);
+                    }
+                    return first + len;
+                }
+
+                *p++ = digits[0];
+                if (n > 1) {
+                    *p++ = '.';
+                    std::memcpy(p, digits + 1, n - 1);
+                    p += n - 1;
+                }
+                p = write_exp(p, 'e', x, 2);
+            }
+
+            if (last - first < p - buf)
+                return nullptr;
+            std::memcpy(first, buf, p - buf);
+            return first + (p - buf);
+        }
+
+    } // namespace detail
+} // namespace ard
+
+#if __cplusplus >= 201703L || defined(_GLIBCXX_CHARCONV)
+// vlta: also when <charconv> of libstdc++ is already included in C++14,
+// where it is provided as an extension (with integer conversions only
+// before GCC 11)
+#include <charconv>
+#else
+// vlta: <charconv> is never included by other library headers, keep it
+// out by its include guard
+#define _GLIBCXX_CHARCONV 1
+
+#include <system_error>
+
+namespace std
+{
+    /// Result type of std::to_chars
+    struct to_chars_result
+    {
+        char* ptr;
+        errc ec;
+    };
+
+    /// Result type of std::from_chars
+    struct from_chars_result
+    {
+        const char* ptr;
+        errc ec;
+    };
+
+    /// floating-point format for primitive numerical conversion
+    enum class chars_format
+    {
+        scientific = 1, fixed = 2, hex = 4, general = fixed | scientific
+    };
+
+    constexpr chars_format
+    operator|(chars_format __lhs, chars_format __rhs) noexcept
+    { return (chars_format)((unsigned)__lhs | (unsigned)__rhs); }
+
+    constexpr chars_format
+    operator&(chars_format __lhs, chars_format __rhs) noexcept
+    { return (chars_format)((unsigned)__lhs & (unsigned)__rhs); }
+
+    constexpr chars_format
+    operator^(chars_format __lhs, chars_format __rhs) noexcept
+    { return (chars_format)((unsigned)__lhs ^ (unsigned)__rhs); }
+
+    constexpr chars_format
+    operator~(chars_format __fmt) noexcept
+    { return (chars_format)~(unsigned)__fmt; }
+
+    constexpr chars_format&
+    operator|=(chars_format& __lhs, chars_format __rhs) noexcept
+    { return __lhs = __lhs | __rhs; }
+
+    constexpr chars_format&
+    operator&=(chars_format& __lhs, chars_format __rhs) noexcept
+    { return __lhs = __lhs & __rhs; }
+
+    constexpr chars_format&
+    operator^=(chars_format& __lhs, chars_format __rhs) noexcept
+    { return __lhs = __lhs ^ __rhs; }
+
+namespace __detail
+{
+namespace __charconv
+{
+    template <typename _Tp>
+    using __integer_t = enable_if_t<is_integral<_Tp>::value
+        && !is_same<remove_cv_t<_Tp>, bool>::value>;
+
+    // Value of digit in bases up to 36, or 127 if not a digit
+    constexpr unsigned char
+    __digit_value(char __c) noexcept
+    {
+        return __c >= '0' && __c <= '9' ? __c - '0'
+            : __c >= 'a' && __c <= 'z' ? __c - 'a' + 10
+            : __c >= 'A' && __c <= 'Z' ? __c - 'A' + 10
+            : 127;
+    }
+
+    // Parse base 10 digits, __first is left after the last digit.
+    // Returns false on overflow.
+    template <typename _Up>
+    bool
+    __parse_dec(const char*& __first, const char* __last, _Up& __val) noexcept
+    {
+        // As many digits as always fit, need no overflow check
+        constexpr int __safe = numeric_limits<_Up>::digits10;
+        const char* __safe_last =
+            __last - __first > __safe ? __first + __safe : __last;
+        for (; __first != __safe_last; ++__first) {
+            const unsigned __d = unsigned(*__first - '0');
+            if (__d >= 10)
+                return true;
+            __val = __val * 10 + __d;
+        }
+
+        bool __ok = true;
+        for (; __first != __last; ++__first) {
+            const unsigned __d = unsigned(*__first - '0');
+            if (__d >= 10)
+                break;
+            if (__ok && (__builtin_mul_overflow(__val, 10u, &__val)
+                    || __builtin_add_overflow(__val, __d, &__val)))
+                __ok = false;
+        }
+        return __ok;
+    }
+
+    // Parse digits in any base up to 36, same as __parse_dec
+    template <typename _Up>
+    bool
+    __parse_alnum(const char*& __first, const char* __last, _Up& __val,
+        int __base) noexcept
+    {
+        bool __ok = true;
+        for (; __first != __last; ++__first) {
+            const unsigned __d = __digit_value(*__first);
+            if (__d >= unsigned(__base))
+                break;
+            if (__ok && (__builtin_mul_overflow(__val, unsigned(__base), &__val)
+                    || __builtin_add_overflow(__val, __d, &__val)))
+                __ok = false;
+        }
+        return __ok;
+    }
+
+    template <typename _Tp>
+    struct __float_traits;
+
+    template <>
+    struct __float_traits<float>
+    {
+        using __uint = uint32_t;
+        static constexpr int __mant_bits = 23;
+        static constexpr int __exp_bias = 127;
+        // Largest power of ten that is exact
+        static constexpr int __exact_pow10 = 10;
+        // Decimal exponent range of nonzero finite values
+        static constexpr int __min_exp10 = -46;
+        static constexpr int __max_exp10 = 39;
+        // Significant digits that decide rounding of any decimal input
+        // (halfway points have up to 112), and big integer to hold them
+        // scaled to halfway
+        static constexpr int __exact_digits = 113;
+        static constexpr int __bigint_words = 16;
+    };
+
+    template <>
+    struct __float_traits<double>
+    {
+        using __uint = uint64_t;
+        static constexpr int __mant_bits = 52;
+        static constexpr int __exp_bias = 1023;
+        static constexpr int __exact_pow10 = 22;
+        static constexpr int __min_exp10 = -324;
+        static constexpr int __max_exp10 = 309;
+        // Halfway points have up to 767 digits, 5^1093 * 2^54 < 2^2688
+        static constexpr int __exact_digits = 768;
+        static constexpr int __bigint_words = 84;
+    };
+
+    // Exact powers of ten
+    inline double
+    __pow10(int __i) noexcept
+    {
+        static const double __table[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        return __table[__i];
+    }
+
+    // Round __f * 2^__e (__f != 0) to nearest, ties to even. __sticky
+    // tells that there are nonzero bits below __f.
+    template <typename _Tp>
+    errc
+    __make_float(uint64_t __f, int __e, bool __sticky, _Tp& __value) noexcept
+    {
+        using _Traits = __float_traits<_Tp>;
+        using _Uint = typename _Traits::__uint;
+
+        const int __lz = __builtin_clzll(__f);
+        __f <<= __lz;
+        // Value is in [2^__exp, 2^(__exp + 1))
+        const int __exp = __e - __lz + 63;
+        if (__exp > _Traits::__exp_bias)
+            return errc::result_out_of_range;
+
+        // Number of bits below mantissa, more for subnormals
+        const int __min_exp = 1 - _Traits::__exp_bias;
+        int __shift = 63 - _Traits::__mant_bits;
+        const bool __subnormal = __exp < __min_exp;
+        if (__subnormal)
+            __shift += __min_exp - __exp;
+
+        uint64_t __m;
+        if (__shift < 64) {
+            const uint64_t __half = uint64_t(1) << (__shift - 1);
+            const uint64_t __rest = __f & ((__half << 1) - 1);
+            __m = __f >> __shift;
+            if (__rest > __half || (__rest == __half && (__sticky || (__m & 1))))
+                ++__m;
+        }
+        else if (__shift == 64)
+            __m = __f > (uint64_t(1) << 63) || __sticky;
+        else
+            __m = 0;
+        if (__m == 0)
+            return errc::result_out_of_range;
+
+        // Carry of rounding moves into exponent field by itself
+        const _Uint __bits = __subnormal ? _Uint(__m)
+            : (_Uint(__exp + _Traits::__exp_bias - 1) << _Traits::__mant_bits)
+              + _Uint(__m);
+        if ((__bits >> _Traits::__mant_bits) >= 2 * _Traits::__exp_bias + 1)
+            return errc::result_out_of_range;
+        memcpy(&__value, &__bits, sizeof(__bits));
+        return {};
+    }
+
+    // Whether decimal digits in [__first, __last) (significant ones, may
+    // hold a dot) rounds above float with bits __lo. __top is the decimal
+    // exponent just past the first digit. Digits past __exact_digits can
+    // not land on halfway, they only count as being nonzero.
+    template <typename _Tp>
+    __attribute__((__noinline__)) bool
+    __round_up(const char* __first, const char* __last, int __top,
+        typename __float_traits<_Tp>::__uint __lo) noexcept
+    {
+        using _Traits = __float_traits<_Tp>;
+        using _Big = ::ard::detail::bigint<_Traits::__bigint_words>;
+
+        // Halfway is (2 * mant + 1) * 2^(__e2 - 1)
+        const int __field = int(__lo >> _Traits::__mant_bits);
+        uint64_t __mant = __lo & ((uint64_t(1) << _Traits::__mant_bits) - 1);
+        int __e2 = 1 - _Traits::__exp_bias - _Traits::__mant_bits;
+        if (__field) {
+            __mant |= uint64_t(1) << _Traits::__mant_bits;
+            __e2 += __field - 1;
+        }
+
+        // Digits in chunks of 9
+        _Big __d;
+        int __count = 0;
+        uint32_t __chunk = 0;
+        int __len = 0;
+        const char* __p = __first;
+        for (; __p != __last && __count < _Traits::__exact_digits; ++__p) {
+            if (*__p == '.')
+                continue;
+            __chunk = __chunk * 10 + unsigned(*__p - '0');
+            ++__count;
+            if (++__len == 9) {
+                __d.mul_add(1000000000, __chunk);
+                __chunk = 0;
+                __len = 0;
+            }
+        }
+        for (; __p != __last; ++__p)
+            if (*__p != '0' && *__p != '.') {
+                __chunk = __chunk * 10 + 1;
+                ++__count;
+                ++__len;
+                break;
+            }
+        if (__len)
+            __d.mul_add(uint32_t(__pow10(__len)), __chunk);
+
+        // Compare __d * 10^__e10 with halfway, powers of two cancelled
+        const int __e10 = __top - __count;
+        _Big __h(2 * __mant + 1);
+        if (__e10 >= 0)
+            __d.mul_pow5(__e10);
+        else
+            __h.mul_pow5(-__e10);
+        const int __twos = __e2 - 1 - __e10;
+        if (__twos >= 0)
+            __h.shift_left(__twos);
+        else
+            __d.shift_left(-__twos);
+
+        const int __cmp = compare(__d, __h);
+        return __cmp > 0 || (__cmp == 0 && (__mant & 1));
+    }
+
+    // Convert __m * 10^__e10, __ndigits is the number of digits of __m.
+    // They are the first of significant digits in [__first, __last), and
+    // __sticky tells that more of them are nonzero.
+    template <typename _Tp>
+    errc
+    __from_decimal(uint64_t __m, int __e10, int __ndigits, bool __sticky,
+        const char* __first, const char* __last, _Tp& __value) noexcept
+    {
+        using _Traits = __float_traits<_Tp>;
+
+        if (__m == 0) {
+            __value = 0;
+            return {};
+        }
+        if (__ndigits + __e10 > _Traits::__max_exp10
+                || __ndigits + __e10 < _Traits::__min_exp10)
+            return errc::result_out_of_range;
+
+        // Clinger's fast path, mantissa and power of ten are exact, so is
+        // the result of one multiply or divide
+        if (!__sticky && __m <= (uint64_t(1) << (_Traits::__mant_bits + 1))
+                && __e10 >= -_Traits::__exact_pow10
+                && __e10 <= _Traits::__exact_pow10) {
+            if (__e10 >= 0)
+                __value = _Tp(__m) * _Tp(__pow10(__e10));
+            else
+                __value = _Tp(__m) / _Tp(__pow10(-__e10));
+            return {};
+        }
+
+        // 10^__e10 = 10^__r * 10^__k, with cached 10^__k
+        using ::ard::detail::cached_power_min_exp10;
+        using ::ard::detail::cached_power_step;
+        const int __r = (__e10 - cached_power_min_exp10) % cached_power_step;
+        const int __k = __e10 - __r;
+        const int __lz = __builtin_clzll(__m);
+        ::ard::detail::diy_fp __x = { __m << __lz, -__lz };
+        if (__r) {
+            const uint64_t __p = uint64_t(__pow10(__r));
+            const int __plz = __builtin_clzll(__p);
+            __x = ::ard::detail::multiply(__x, { __p << __plz, -__plz });
+        }
+        __x = ::ard::detail::multiply(__x, ::ard::detail::cached_power(
+            (__k - cached_power_min_exp10) / cached_power_step));
+
+        // Round both ends of error interval, they differ only when it
+        // holds a halfway point, compare with that exactly then
+        using _Uint = typename _Traits::__uint;
+        const uint64_t __err = __sticky ? 40 : 8;
+        const uint64_t __f_hi = __x.f + __err < __x.f
+            ? ~uint64_t(0) : __x.f + __err;
+        _Tp __lo, __hi;
+        const errc __lo_ec = __make_float(__x.f - __err, __x.e, false, __lo);
+        const errc __hi_ec = __make_float(__f_hi, __x.e, false, __hi);
+        if (__lo_ec == __hi_ec
+                && (__lo_ec != errc{} || memcmp(&__lo, &__hi, sizeof(_Tp)) == 0)) {
+            if (__lo_ec == errc{})
+                __value = __lo;
+            return __lo_ec;
+        }
+
+        // Low end may have underflowed to zero
+        _Uint __bits = 0;
+        if (__lo_ec == errc{})
+            memcpy(&__bits, &__lo, sizeof(__bits));
+        __bits += __round_up<_Tp>(__first, __last, __e10 + __ndigits, __bits);
+        if (__bits == 0 || (__bits >> _Traits::__mant_bits) >= 2 * _Traits::__exp_bias + 1)
+            return errc::result_out_of_range;
+        memcpy(&__value, &__bits, sizeof(__bits));
+        return {};
+    }
+
+    // Case insensitive match of lower case __str at __first
+    inline bool
+    __match(const char* __first, const char* __last, const char* __str) noexcept
+    {
+        for (; *__str; ++__first, ++__str)
+            if (__first == __last || (*__first | 0x20) != *__str)
+                return false;
+        return true;
+    }
+
+    // Parse inf, infinity, nan and nan(chars), returns end of match or
+    // null if there is none
+    template <typename _Tp>
+    const char*
+    __parse_special(const char* __first, const char* __last, _Tp& __value) noexcept
+    {
+        if (__match(__first, __last, "inf")) {
+            __value = numeric_limits<_Tp>::infinity();
+            return __first + (__match(__first, __last, "infinity") ? 8 : 3);
+        }
+        if (__match(__first, __last, "nan")) {
+            __value = numeric_limits<_Tp>::quiet_NaN();
+            __first += 3;
+            if (__first != __last && *__first == '(') {
+                const char* __p = __first + 1;
+                while (__p != __last && (__digit_value(*__p) < 36 || *__p == '_'))
+                    ++__p;
+                if (__p != __last && *__p == ')')
+                    __first = __p + 1;
+            }
+            return __first;
+        }
+        return nullptr;
+    }
+
+    // Parse exponent, returns false if there is no digit
+    inline bool
+    __parse_exp(const char*& __first, const char* __last, int& __exp) noexcept
+    {
+        const char* __p = __first;
+        bool __neg = false;
+        if (__p != __last && (*__p == '-' || *__p == '+'))
+            __neg = *__p++ == '-';
+        if (__p == __last || unsigned(*__p - '0') >= 10)
+            return false;
+
+        // Saturate, far beyond any representable value
+        int __e = 0;
+        for (; __p != __last && unsigned(*__p - '0') < 10; ++__p)
+            if (__e < 100000)
+                __e = __e * 10 + (*__p - '0');
+        __exp = __neg ? -__e : __e;
+        __first = __p;
+        return true;
+    }
+
+    template <typename _Tp>
+    from_chars_result
+    __from_chars_float(const char* __first, const char* __last, _Tp& __value,
+        chars_format __fmt) noexcept
+    {
+        const char* __p = __first;
+        const bool __neg = __p != __last && *__p == '-';
+        if (__neg)
+            ++__p;
+
+        _Tp __result;
+        errc __ec = {};
+        if (const char* __end = __parse_special(__p, __last, __result))
+            __p = __end;
+        else {
+            const bool __hex = __fmt == chars_format::hex;
+            const unsigned __base = __hex ? 16 : 10;
+            // Significant digits that fit in 64 bits
+            const int __max_digits = __hex ? 16 : 19;
+
+            uint64_t __m = 0;
+            int __ndigits = 0;
+            // Significant digits start here
+            const char* __digits = nullptr;
+            int __exp = 0;
+            bool __sticky = false;
+            bool __any = false;
+
+            // Digits, dot and more digits, leading zeros are skipped
+            for (bool __frac = false; __p != __last; ++__p) {
+                if (*__p == '.' && !__frac) {
+                    __frac = true;
+                    continue;
+                }
+                const unsigned __d = __digit_value(*__p);
+                if (__d >= __base)
+                    break;
+                __any = true;
+                if (__ndigits < __max_digits) {
+                    if (__m || __d) {
+                        if (!__m)
+                            __digits = __p;
+                        __m = __m * __base + __d;
+                        ++__ndigits;
+                    }
+                    if (__frac)
+                        --__exp;
+                }
+                else {
+                    __sticky |= __d != 0;
+                    if (!__frac)
+                        ++__exp;
+                }
+            }
+            if (!__any)
+                return { __first, errc::invalid_argument };
+            const char* const __digits_end = __p;
+
+            // Exponent is required by scientific and not allowed by fixed
+            const char __exp_char = __hex ? 'p' : 'e';
+            bool __has_exp = false;
+            int __e = 0;
+            if ((__fmt & chars_format::scientific) == chars_format::scientific
+                    || __hex) {
+                if (__p != __last && (*__p | 0x20) == __exp_char) {
+                    const char* __q = __p + 1;
+                    if (__parse_exp(__q, __last, __e)) {
+                        __p = __q;
+                        __has_exp = true;
+                    }
+                }
+                if (!__has_exp && __fmt == chars_format::scientific)
+                    return { __first, errc::invalid_argument };
+            }
+
+            if (__hex) {
+                if (__m == 0)
+                    __result = 0;
+                else
+                    __ec = __make_float(__m, __exp * 4 + __e, __sticky, __result);
+            }
+            else
+                __ec = __from_decimal(__m, __exp + __e, __ndigits, __sticky,
+                    __digits, __digits_end, __result);
+        }
+
+        if (__ec == errc{})
+            __value = __neg ? -__result : __result;
+        return { __p, __ec };
+    }
+
+} // namespace __charconv
+} // namespace __detail
+
+    /// std::from_chars for integral types
+    template <typename _Tp,
+              typename = __detail::__charconv::__integer_t<_Tp>>
+    from_chars_result
+    from_chars(const char* __first, const char* __last, _Tp& __value,
+        int __base = 10) noexcept
+    {
+        using namespace __detail::__charconv;
+        using _Up = make_unsigned_t<_Tp>;
+
+        const char* __p = __first;
+        bool __neg = false;
+        if (is_signed<_Tp>::value && __p != __last && *__p == '-') {
+            __neg = true;
+            ++__p;
+        }
+
+        const char* __start = __p;
+        _Up __val = 0;
+        bool __ok = __base == 10
+            ? __parse_dec(__p, __last, __val)
+            : __parse_alnum(__p, __last, __val, __base);
+        if (__p == __start)
+            return { __first, errc::invalid_argument };
+
+        if (is_signed<_Tp>::value) {
+            // Magnitude of min() is one more than max()
+            const _Up __max = _Up(numeric_limits<_Tp>::max()) + __neg;
+            __ok = __ok && __val <= __max;
+        }
+        if (!__ok)
+            return { __p, errc::result_out_of_range };
+
+        __value = __neg ? _Tp(_Up(0) - __val) : _Tp(__val);
+        return { __p, errc{} };
+    }
+
+    /// std::from_chars for floating point types
+    inline from_chars_result
+    from_chars(const char* __first, const char* __last, float& __value,
+        chars_format __fmt = chars_format::general) noexcept
+    { return __detail::__charconv::__from_chars_float(__first, __last, __value, __fmt); }
+
+    inline from_chars_result
+    from_chars(const char* __first, const char* __last, double& __value,
+        chars_format __fmt = chars_format::general) noexcept
+    { return __detail::__charconv::__from_chars_float(__first, __last, __value, __fmt); }
+
+    // vlta: parsed as double
+    inline from_chars_result
+    from_chars(const char* __first, const char* __last, long double& __value,
+        chars_format __fmt = chars_format::general) noexcept
+    {
+        double __d;
+        from_chars_result __res = from_chars(__first, __last, __d, __fmt);
+        if (__res.ec == errc{})
+            __value = __d;
+        return __res;
+    }
+
+    /// std::to_chars for integral types
+    template <typename _Tp,
+              typename = __detail::__charconv::__integer_t<_Tp>>
+    to_chars_result
+    to_chars(char* __first, char* __last, _Tp __value, int __base = 10) noexcept
+    {
+        using _Up = make_unsigned_t<_Tp>;
+
+        _Up __u = __value;
+        if (__value < 0) {
+            if (__first == __last)
+                return { __last, errc::value_too_large };
+            *__first++ = '-';
+            __u = _Up(0) - __u;
+        }
+
+        const unsigned __b = __base;
+        int __len = 1;
+        for (_Up __v = __u; __v >= __b; __v /= __b)
+            ++__len;
+        if (__last - __first < __len)
+            return { __last, errc::value_too_large };
+
+        // Base 10 is divided by constant
+        char* __p = __first + __len;
+        if (__base == 10) {
+            do {
+                *--__p = char('0' + __u % 10);
+                __u /= 10;
+            } while (__u);
+        }
+        else {
+            do {
+                *--__p = "0123456789abcdefghijklmnopqrstuvwxyz"[__u % __b];
+                __u /= __b;
+            } while (__u);
+        }
+        return { __first + __len, errc{} };
+    }
+
+    to_chars_result
+    to_chars(char*, char*, bool, int = 10) = delete;
+
+    /// std::to_chars for floating point types, shortest representation
+    /// that reads back to the same value
+    inline to_chars_result
+    to_chars(char* __first, char* __last, float __value) noexcept
+    {
+        char* __p = ::ard::detail::float_to_chars(__first, __last, __value, 0);
+        return __p ? to_chars_result{ __p, errc{} }
+            : to_chars_result{ __last, errc::value_too_large };
+    }
+
+    inline to_chars_result
+    to_chars(char* __first, char* __last, float __value,
+        chars_format __fmt) noexcept
+    {
+        char* __p = ::ard::detail::float_to_chars(__first, __last, __value,
+            unsigned(__fmt));
+        return __p ? to_chars_result{ __p, errc{} }
+            : to_chars_result{ __last, errc::value_too_large };
+    }
+
+    inline to_chars_result
+    to_chars(char* __first, char* __last, double __value) noexcept
+    {
+        char* __p = ::ard::detail::float_to_chars(__first, __last, __value, 0);
+        return __p ? to_chars_result{ __p, errc{} }
+            : to_chars_result{ __last, errc::value_too_large };
+    }
+
+    inline to_chars_result
+    to_chars(char* __first, char* __last, double __value,
+        chars_format __fmt) noexcept
+    {
+        char* __p = ::ard::detail::float_to_chars(__first, __last, __value,
+            unsigned(__fmt));
+        return __p ? to_chars_result{ __p, errc{} }
+            : to_chars_result{ __last, errc::value_too_large };
+    }
+
+    // vlta: written as double
+    inline to_chars_result
+    to_chars(char* __first, char* __last, long double __value) noexcept
+    { return to_chars(__first, __last, double(__value)); }
+
+    inline to_chars_result
+    to_chars(char* __first, char* __last, long double __value,
+        chars_format __fmt) noexcept
+    { return to_chars(__first, __last, double(__value), __fmt); }
+
+} // namespace std
+#endif // __cplusplus >= 201703L
+
+namespace ard
+{
+    // from_chars() of whole string (any type providing data() and size(),
+    // such as string_view), returned ptr points into str
+
+    template <class S, class T>
+    auto from_chars(const S& str, T& value, int base = 10) noexcept
+        -> std::enable_if_t<std::is_integral<T>::value,
+            decltype(str.data(), str.size(), std::from_chars_result())>
+    { return std::from_chars(str.data(), str.data() + str.size(), value, base); }
+
+    template <class S, class T>
+    auto from_chars(const S& str, T& value,
+        std::chars_format fmt = std::chars_format::general) noexcept
+        -> std::enable_if_t<std::is_floating_point<T>::value,
+            decltype(str.data(), str.size(), std::from_chars_result())>
+    { return std::from_chars(str.data(), str.data() + str.size(), value, fmt); }
+
+} // namespace ard
@@ -0,0 +1,469 @@
+// Optional value without engaged flag
+// Vladimir Talybin (2021)
+//
+// File version: 1.0.0
+//
+// Same interface as std::optional, but "empty" is a reserved value of T
+// (sentinel) instead of a separate bool. It has the size of T, half of
+// std::optional<float> or std::optional<uint16_t>:
+//
+//   ard::compact_optional<float> temp;            // empty is NaN
+//   ard::compact_optional<uint16_t> level;        // empty is 0xffff
+//   ard::compact_optional<int, ard::sentinel_traits<int, -1>> index;
+//
+// Sentinel is given by traits with two static members:
+//
+//   static constexpr T empty_value() noexcept;
+//   static constexpr bool is_empty(const T&) noexcept;
+//
+// Default traits are nan_traits for floating point (does not work with
+// -ffast-math), null_traits for pointers and sentinel_traits with max
+// value (unsigned) or min value (signed) for integers. Assigning the
+// sentinel value makes the optional empty.
+//
+// It compares with std::optional as two std::optional do, converts from
+// and to it, and hashes the same as std::optional of the same value.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <utility>
+#include "type_traits.hpp"
+#include "optional.hpp"
+#include "exception.hpp"
+
+namespace ard
+{
+    // Empty is a reserved value
+    template <class T, T Value>
+    struct sentinel_traits {
+        static constexpr T empty_value() noexcept
+        { return Value; }
+
+        static constexpr bool is_empty(const T& v) noexcept
+        { return v == Value; }
+    };
+
+    // Empty is quiet NaN, any NaN reads as empty
+    template <class T>
+    struct nan_traits {
+        static_assert(std::numeric_limits<T>::has_quiet_NaN, "nan_traits needs a type with NaN");
+
+        static constexpr T empty_value() noexcept
+        { return std::numeric_limits<T>::quiet_NaN(); }
+
+        static constexpr bool is_empty(const T& v) noexcept
+        { return v != v; }
+    };
+
+    // Empty is null pointer
+    template <class T>
+    struct null_traits {
+        static constexpr T empty_value() noexcept
+        { return nullptr; }
+
+        static constexpr bool is_empty(const T& v) noexcept
+        { return v == nullptr; }
+    };
+
+    template <class T, class Traits>
+    class compact_optional;
+
+    namespace detail
+    {
+        template <class T, class = void>
+        struct compact_traits { };
+
+        template <class T>
+        struct compact_traits<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+            using type = nan_traits<T>;
+        };
+
+        template <class T>
+        struct compact_traits<T, std::enable_if_t<std::is_pointer<T>::value>> {
+            using type = null_traits<T>;
+        };
+
+        template <class T>
+        struct compact_traits<T, std::enable_if_t<
+            std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+        {
+            using type = sentinel_traits<T, std::is_signed<T>::value
+                ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max()>;
+        };
+
+        template <class U>
+        struct is_optional_like : std::false_type { };
+
+        template <class U>
+        struct is_optional_like<std::optional<U>> : std::true_type { };
+
+        template <class U, class Tr>
+        struct is_optional_like<compact_optional<U, Tr>> : std::true_type { };
+
+        // Argument of converting constructor and assignment from value
+        template <class T, class U>
+        using compact_value_arg = std::integral_constant<bool,
+            std::is_constructible<T, U&&>::value
+            && !is_optional_like<std::decay_t<U>>::value
+            && !std::is_same<std::decay_t<U>, std::in_place_t>::value
+            && !std::is_same<std::decay_t<U>, std::nullopt_t>::value>;
+
+    } // namespace detail
+
+    // Default traits of T, not defined for other types
+    template <class T>
+    using compact_traits_t = typename detail::compact_traits<T>::type;
+
+    // Optional keeping empty state in the value
+    template <class T, class Traits = compact_traits_t<T>>
+    class compact_optional
+    {
+        static_assert(!std::is_reference<T>::value, "compact_optional of reference");
+        static_assert(!std::is_const<T>::value, "compact_optional of const type");
+
+        // Constraints of converting constructors, implicit if U converts
+        template <class U, bool Implicit>
+        using value_ctor = std::enable_if_t<detail::compact_value_arg<T, U>::value
+            && std::is_convertible<U&&, T>::value == Implicit, bool>;
+
+        template <class U, bool Implicit>
+        using optional_ctor = std::enable_if_t<std::is_constructible<T, U>::value
+            && std::is_convertible<U, T>::value == Implicit, bool>;
+
+        T val_;
+
+    public:
+        using value_type = T;
+        using traits_type = Traits;
+
+        constexpr compact_optional() noexcept
+        : val_(Traits::empty_value())
+        { }
+
+        constexpr compact_optional(std::nullopt_t) noexcept
+        : compact_optional()
+        { }
+
+        template <class U = T, value_ctor<U, true> = true>
+        constexpr compact_optional(U&& v)
+        : val_(std::forward<U>(v))
+        { }
+
+        template <class U = T, value_ctor<U, false> = false>
+        constexpr explicit compact_optional(U&& v)
+        : val_(std::forward<U>(v))
+        { }
+
+        template <class... Args>
+        constexpr explicit compact_optional(std::in_place_t, Args&&... args)
+        : val_(std::forward<Args>(args)...)
+        { }
+
+        // Conversion from other optionals, their empty state maps to
+        // the sentinel
+        template <class U, optional_ctor<const U&, true> = true>
+        constexpr compact_optional(const std::optional<U>& opt)
+        : val_(opt ? T(*opt) : Traits::empty_value())
+        { }
+
+        template <class U, optional_ctor<const U&, false> = false>
+        constexpr explicit compact_optional(const std::optional<U>& opt)
+        : val_(opt ? T(*opt) : Traits::empty_value())
+        { }
+
+        template <class U, class Tr, optional_ctor<const U&, true> = true>
+        constexpr compact_optional(const compact_optional<U, Tr>& opt)
+        : val_(opt ? T(*opt) : Traits::empty_value())
+        { }
+
+        template <class U, class Tr, optional_ctor<const U&, false> = false>
+        constexpr explicit compact_optional(const compact_optional<U, Tr>& opt)
+        : val_(opt ? T(*opt) : Traits::empty_value())
+        { }
+
+        compact_optional& operator=(std::nullopt_t) noexcept {
+            reset();
+            return *this;
+        }
+
+        // Not for scalar T, so that opt = {} makes it empty, as with
+        // std::optional
+        template <class U = T>
+        auto operator=(U&& v)
+        -> std::enable_if_t<detail::compact_value_arg<T, U>::value
+            && std::is_assignable<T&, U>::value
+            && !(std::is_scalar<T>::value && std::is_same<T, std::decay_t<U>>::value),
+            compact_optional&>
+        {
+            val_ = std::forward<U>(v);
+            return *this;
+        }
+
+        template <class U>
+        auto operator=(const std::optional<U>& opt)
+        -> std::enable_if_t<std::is_constructible<T, const U&>::value, compact_optional&>
+        {
+            if (opt)
+                val_ = T(*opt);
+            else
+                reset();
+            return *this;
+        }
+
+        // Destroys old value and constructs new one in its place
+        template <class... Args>
+        T& emplace(Args&&... args) {
+            val_.~T();
+            ::new ((void*)std::addressof(val_)) T(std::forward<Args>(args)...);
+            return val_;
+        }
+
+        void reset() noexcept
+        { val_ = Traits::empty_value(); }
+
+        void swap(compact_optional& other) noexcept(std::is_nothrow_swappable<T>::value) {
+            using std::swap;
+            swap(val_, other.val_);
+        }
+
+        // Observers
+        constexpr bool has_value() const noexcept
+        { return !Traits::is_empty(val_); }
+
+        constexpr explicit operator bool() const noexcept
+        { return has_value(); }
+
+        constexpr const T* operator->() const noexcept
+        { return &val_; }
+
+        constexpr T* operator->() noexcept
+        { return &val_; }
+
+        constexpr const T& operator*() const& noexcept
+        { return val_; }
+
+        constexpr T& operator*() & noexcept
+        { return val_; }
+
+        constexpr T&& operator*() && noexcept
+        { return std::move(val_); }
+
+        constexpr const T& value() const& {
+            if (!has_value())
+                throw_exception(std::bad_optional_access());
+            return val_;
+        }
+
+        constexpr T& value() & {
+            if (!has_value())
+                throw_exception(std::bad_optional_access());
+            return val_;
+        }
+
+        constexpr T&& value() && {
+            if (!has_value())
+                throw_exception(std::bad_optional_access());
+            return std::move(val_);
+        }
+
+        template <class U>
+        constexpr T value_or(U&& u) const&
+        { return has_value() ? val_ : static_cast<T>(std::forward<U>(u)); }
+
+        template <class U>
+        constexpr T value_or(U&& u) &&
+        { return has_value() ? std::move(val_) : static_cast<T>(std::forward<U>(u)); }
+
+        // Conversion to std::optional
+        constexpr operator std::optional<T>() const {
+            return has_value() ? std::optional<T>(val_) : std::optional<T>();
+        }
+    };
+
+    template <class T, class Tr>
+    void swap(compact_optional<T, Tr>& lhs, compact_optional<T, Tr>& rhs)
+    noexcept(noexcept(lhs.swap(rhs)))
+    { lhs.swap(rhs); }
+
+    // Comparisons, empty is equal to empty and less than any value
+    template <class T, class Tr>
+    constexpr bool operator==(const compact_optional<T, Tr>& lhs, const compact_optional<T, Tr>& rhs)
+    { return lhs.has_value() == rhs.has_value() && (!lhs || *lhs == *rhs); }
+
+    template <class T, class Tr>
+    constexpr bool operator!=(const compact_optional<T, Tr>& lhs, const compact_optional<T, Tr>& rhs)
+    { return !(lhs == rhs); }
+
+    template <class T, class Tr>
+    constexpr bool operator<(const compact_optional<T, Tr>& lhs, const compact_optional<T, Tr>& rhs)
+    { return rhs.has_value() && (!lhs || *lhs < *rhs); }
+
+    template <class T, class Tr>
+    constexpr bool operator>(const compact_optional<T, Tr>& lhs, const compact_optional<T, Tr>& rhs)
+    { return rhs < lhs; }
+
+    template <class T, class Tr>
+    constexpr bool operator<=(const compact_optional<T, Tr>& lhs, const compact_optional<T, Tr>& rhs)
+    { return !(rhs < lhs); }
+
+    template <class T, class Tr>
+    constexpr bool operator>=(const compact_optional<T, Tr>& lhs, const compact_optional<T, Tr>& rhs)
+    { return !(lhs < rhs); }
+
+    template <class T, class Tr>
+    constexpr bool operator==(const compact_optional<T, Tr>& lhs, std::nullopt_t) noexcept
+    { return !lhs; }
+
+    template <class T, class Tr>
+    constexpr bool operator==(std::nullopt_t, const compact_optional<T, Tr>& rhs) noexcept
+    { return !rhs; }
+
+    template <class T, class Tr>
+    constexpr bool operator!=(const compact_optional<T, Tr>& lhs, std::nullopt_t) noexcept
+    { return static_cast<bool>(lhs); }
+
+    template <class T, class Tr>
+    constexpr bool operator!=(std::nullopt_t, const compact_optional<T, Tr>& rhs) noexcept
+    { return static_cast<bool>(rhs); }
+
+    // With std::optional, same as between two std::optional (more
+    // specialized than its comparisons with any value)
+    template <class T, class Tr, class U>
+    constexpr auto operator==(const compact_optional<T, Tr>& lhs, const std::optional<U>& rhs)
+    -> decltype(bool(*lhs == *rhs))
+    { return bool(lhs) == bool(rhs) && (!lhs || *lhs == *rhs); }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator!=(const compact_optional<T, Tr>& lhs, const std::optional<U>& rhs)
+    -> decltype(bool(*lhs != *rhs))
+    { return bool(lhs) != bool(rhs) || (lhs && *lhs != *rhs); }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator<(const compact_optional<T, Tr>& lhs, const std::optional<U>& rhs)
+    -> decltype(bool(*lhs < *rhs))
+    { return rhs && (!lhs || *lhs < *rhs); }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator>(const compact_optional<T, Tr>& lhs, const std::optional<U>& rhs)
+    -> decltype(bool(*lhs > *rhs))
+    { return lhs && (!rhs || *lhs > *rhs); }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator<=(const compact_optional<T, Tr>& lhs, const std::optional<U>& rhs)
+    -> decltype(bool(*lhs <= *rhs))
+    { return !lhs || (rhs && *lhs <= *rhs); }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator>=(const compact_optional<T, Tr>& lhs, const std::optional<U>& rhs)
+    -> decltype(bool(*lhs >= *rhs))
+    { return !rhs || (lhs && *lhs >= *rhs); }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator==(const std::optional<U>& lhs, const compact_optional<T, Tr>& rhs)
+    -> decltype(bool(*lhs == *rhs))
+    { return bool(lhs) == bool(rhs) && (!lhs || *lhs == *rhs); }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator!=(const std::optional<U>& lhs, const compact_optional<T, Tr>& rhs)
+    -> decltype(bool(*lhs != *rhs))
+    { return bool(lhs) != bool(rhs) || (lhs && *lhs != *rhs); }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator<(const std::optional<U>& lhs, const compact_optional<T, Tr>& rhs)
+    -> decltype(bool(*lhs < *rhs))
+    { return rhs && (!lhs || *lhs < *rhs); }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator>(const std::optional<U>& lhs, const compact_optional<T, Tr>& rhs)
+    -> decltype(bool(*lhs > *rhs))
+    { return lhs && (!rhs || *lhs > *rhs); }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator<=(const std::optional<U>& lhs, const compact_optional<T, Tr>& rhs)
+    -> decltype(bool(*lhs <= *rhs))
+    { return !lhs || (rhs && *lhs <= *rhs); }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator>=(const std::optional<U>& lhs, const compact_optional<T, Tr>& rhs)
+    -> decltype(bool(*lhs >= *rhs))
+    { return !rhs || (lhs && *lhs >= *rhs); }
+
+    // With value, U is not an optional
+    template <class T, class Tr, class U>
+    constexpr auto operator==(const compact_optional<T, Tr>& lhs, const U& rhs)
+    -> std::enable_if_t<!detail::is_optional_like<U>::value, decltype(bool(*lhs == rhs))>
+    { return lhs && *lhs == rhs; }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator!=(const compact_optional<T, Tr>& lhs, const U& rhs)
+    -> std::enable_if_t<!detail::is_optional_like<U>::value, decltype(bool(*lhs != rhs))>
+    { return !lhs || *lhs != rhs; }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator<(const compact_optional<T, Tr>& lhs, const U& rhs)
+    -> std::enable_if_t<!detail::is_optional_like<U>::value, decltype(bool(*lhs < rhs))>
+    { return !lhs || *lhs < rhs; }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator>(const compact_optional<T, Tr>& lhs, const U& rhs)
+    -> std::enable_if_t<!detail::is_optional_like<U>::value, decltype(bool(*lhs > rhs))>
+    { return lhs && *lhs > rhs; }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator<=(const compact_optional<T, Tr>& lhs, const U& rhs)
+    -> std::enable_if_t<!detail::is_optional_like<U>::value, decltype(bool(*lhs <= rhs))>
+    { return !lhs || *lhs <= rhs; }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator>=(const compact_optional<T, Tr>& lhs, const U& rhs)
+    -> std::enable_if_t<!detail::is_optional_like<U>::value, decltype(bool(*lhs >= rhs))>
+    { return lhs && *lhs >= rhs; }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator==(const U& lhs, const compact_optional<T, Tr>& rhs)
+    -> std::enable_if_t<!detail::is_optional_like<U>::value, decltype(bool(lhs == *rhs))>
+    { return rhs && lhs == *rhs; }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator!=(const U& lhs, const compact_optional<T, Tr>& rhs)
+    -> std::enable_if_t<!detail::is_optional_like<U>::value, decltype(bool(lhs != *rhs))>
+    { return !rhs || lhs != *rhs; }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator<(const U& lhs, const compact_optional<T, Tr>& rhs)
+    -> std::enable_if_t<!detail::is_optional_like<U>::value, decltype(bool(lhs < *rhs))>
+    { return rhs && lhs < *rhs; }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator>(const U& lhs, const compact_optional<T, Tr>& rhs)
+    -> std::enable_if_t<!detail::is_optional_like<U>::value, decltype(bool(lhs > *rhs))>
+    { return !rhs || lhs > *rhs; }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator<=(const U& lhs, const compact_optional<T, Tr>& rhs)
+    -> std::enable_if_t<!detail::is_optional_like<U>::value, decltype(bool(lhs <= *rhs))>
+    { return rhs && lhs <= *rhs; }
+
+    template <class T, class Tr, class U>
+    constexpr auto operator>=(const U& lhs, const compact_optional<T, Tr>& rhs)
+    -> std::enable_if_t<!detail::is_optional_like<U>::value, decltype(bool(lhs >= *rhs))>
+    { return !rhs || lhs >= *rhs; }
+
+} // namespace ard
+
+namespace std
+{
+    // Same hash as std::optional of the same value
+    template <class T, class Tr>
+    struct hash<ard::compact_optional<T, Tr>>
+    {
+        size_t operator()(const ard::compact_optional<T, Tr>& opt) const
+        noexcept(noexcept(hash<T>{}(*opt)))
+        { return opt ? hash<T>{}(*opt) : static_cast<size_t>(-3333); }
+    };
+
+} // namespace std
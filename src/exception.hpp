@@ -2,40 +2,295 @@
 // Vladimir Talybin (2021)
 //
 // File version: 1.0.0
+//
+// Configuration:
+//  - ARD_ERROR_BUFFER_SIZE, if defined to non-zero, ard::error keeps
+//    its message in a fixed inline buffer of this many bytes (including
+//    null terminator) instead of std::string. Message that do not fit
+//    is truncated. Error paths never allocate from heap in this mode.
+//  - ARD_ERROR_DEFERRED, if defined, ard::error copies streamed strings
+//    to its message but only records numbers (up to
+//    ARD_ERROR_DEFERRED_ARGS, default 8), they are formatted into the
+//    message on first call to what(). Requires ARD_ERROR_BUFFER_SIZE,
+//    so what() never allocates.
+//  - ARD_ERROR_CODES, if defined, library checks throw ard::coded_error
+//    holding a numeric code and source line instead of a message. Its
+//    what() is "ard::error E<code> L<line>", decode it on host with
+//    tools/decode_error.py.
+//
 
 #pragma once
 
 #include <exception>
 #include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include "charconv.hpp"
 
 namespace ard
 {
     // Define this function to catch exception
     extern void on_exception(const std::exception&) __attribute__((weak));
 
+    namespace detail
+    {
+        // Fixed-capacity string, silently truncates on overflow
+        template <size_t N>
+        struct fixed_string {
+            static_assert(N > 1, "fixed_string must have room for text and null terminator");
+
+        private:
+            char buf_[N];
+            size_t len_ = 0;
+
+        public:
+            fixed_string() noexcept
+            { buf_[0] = '\0'; }
+
+            fixed_string(const char* str) noexcept
+            : fixed_string()
+            { append(str); }
+
+            const char* c_str() const noexcept
+            { return buf_; }
+
+            size_t size() const noexcept
+            { return len_; }
+
+            static constexpr size_t capacity() noexcept
+            { return N - 1; }
+
+            fixed_string& append(const char* str, size_t n) noexcept {
+                if (n > capacity() - len_)
+                    n = capacity() - len_;
+                std::memcpy(buf_ + len_, str, n);
+                len_ += n;
+                buf_[len_] = '\0';
+                return *this;
+            }
+
+            fixed_string& append(const char* str) noexcept
+            { return append(str, std::strlen(str)); }
+
+            // Insert at pos <= size(), text moved past capacity is lost
+            fixed_string& insert(size_t pos, const char* str, size_t n) noexcept {
+                if (n > capacity() - pos)
+                    n = capacity() - pos;
+                size_t tail = len_ - pos;
+                if (tail > capacity() - pos - n)
+                    tail = capacity() - pos - n;
+                std::memmove(buf_ + pos + n, buf_ + pos, tail);
+                std::memcpy(buf_ + pos, str, n);
+                len_ = pos + n + tail;
+                buf_[len_] = '\0';
+                return *this;
+            }
+
+            fixed_string& append(size_t n, char c) noexcept {
+                if (n > capacity() - len_)
+                    n = capacity() - len_;
+                std::memset(buf_ + len_, c, n);
+                len_ += n;
+                buf_[len_] = '\0';
+                return *this;
+            }
+
+            // Any string type providing data() and size()
+            template <class S>
+            auto append(const S& str) noexcept -> decltype(str.data(), str.size(), *this)
+            { return append(str.data(), str.size()); }
+        };
+
+    } // namespace detail
+
+    // Message storage of ard::error
+#if defined(ARD_ERROR_BUFFER_SIZE) && ARD_ERROR_BUFFER_SIZE > 0
+    using error_string = detail::fixed_string<ARD_ERROR_BUFFER_SIZE>;
+#else
+    using error_string = std::string;
+#endif
+
+    namespace detail
+    {
+        // Append number to error message, formatted on stack (sized for
+        // all digits and sign). Promotion makes bool a number. Nothing is
+        // appended if conversion fails.
+        template <class S, class T>
+        std::enable_if_t<std::is_integral<T>::value>
+        append_number(S& str, T value) {
+            char buf[std::numeric_limits<T>::digits10 + 3];
+            const auto res = std::to_chars(buf, buf + sizeof(buf), +value);
+            if (res.ec == std::errc{})
+                str.append(buf, res.ptr - buf);
+        }
+
+        // Shortest form that reads back to the same value
+        template <class S, class T>
+        std::enable_if_t<std::is_floating_point<T>::value>
+        append_number(S& str, T value) {
+            using F = std::conditional_t<std::is_same<T, float>::value, float, double>;
+            char buf[32];
+            if (const char* end = float_to_chars(buf, buf + sizeof(buf), F(value), 0))
+                str.append(buf, end - buf);
+        }
+
+#ifdef ARD_ERROR_DEFERRED
+#if !defined(ARD_ERROR_BUFFER_SIZE) || ARD_ERROR_BUFFER_SIZE <= 0
+#error "ARD_ERROR_DEFERRED requires ARD_ERROR_BUFFER_SIZE"
+#endif
+#ifndef ARD_ERROR_DEFERRED_ARGS
+#define ARD_ERROR_DEFERRED_ARGS 8
+#endif
+        // Number recorded by deferred ard::error, with its position in
+        // message
+        struct error_arg {
+            enum kind_t : unsigned char { sint, uint, real };
+
+            error_arg() = default;
+
+            error_arg(size_t p, long long v) noexcept
+            : kind(sint), pos(p)
+            { i = v; }
+
+            error_arg(size_t p, unsigned long long v) noexcept
+            : kind(uint), pos(p)
+            { u = v; }
+
+            error_arg(size_t p, double v) noexcept
+            : kind(real), pos(p)
+            { d = v; }
+
+            kind_t kind;
+            size_t pos;
+            union {
+                long long i;
+                unsigned long long u;
+                double d;
+            };
+
+            void format(error_string& out) const noexcept {
+                fixed_string<32> num;
+                switch (kind) {
+                case sint: append_number(num, i); break;
+                case uint: append_number(num, u); break;
+                case real: append_number(num, d); break;
+                }
+                out.insert(pos, num.c_str(), num.size());
+            }
+        };
+#endif
+
+    } // namespace detail
+
+#ifdef ARD_ERROR_DEFERRED
+    // Streaming exception, formats numbers when needed
+    struct error : std::exception {
+    private:
+        mutable error_string err_;
+        mutable size_t count_ = 0;
+        detail::error_arg args_[ARD_ERROR_DEFERRED_ARGS];
+
+        // Numbers that do not fit are dropped
+        error& push(const detail::error_arg& arg) noexcept {
+            if (count_ < ARD_ERROR_DEFERRED_ARGS)
+                args_[count_++] = arg;
+            return *this;
+        }
+
+    public:
+        error() = default;
+
+        error(error_string err) noexcept
+        : err_(std::move(err))
+        { }
+
+        error(const char* err) noexcept
+        : err_(err)
+        { }
+
+        const char* what() const noexcept override {
+            // From last, so positions of earlier numbers stay valid
+            while (count_ > 0) {
+                --count_;
+                args_[count_].format(err_);
+            }
+            return err_.c_str();
+        }
+
+        template <class T>
+        std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value &&
+            sizeof(T) <= sizeof(long long), error&>
+        operator<<(T arg) noexcept
+        { return push(detail::error_arg(err_.size(), (long long)arg)); }
+
+        template <class T>
+        std::enable_if_t<std::is_integral<T>::value && !std::is_signed<T>::value &&
+            sizeof(T) <= sizeof(long long), error&>
+        operator<<(T arg) noexcept
+        { return push(detail::error_arg(err_.size(), (unsigned long long)arg)); }
+
+        // Wider integers do not fit in record, formatted at once
+        template <class T>
+        std::enable_if_t<std::is_integral<T>::value && (sizeof(T) > sizeof(long long)), error&>
+        operator<<(T arg) noexcept {
+            detail::append_number(err_, arg);
+            return *this;
+        }
+
+        template <class T>
+        std::enable_if_t<std::is_floating_point<T>::value, error&>
+        operator<<(T arg) noexcept
+        { return push(detail::error_arg(err_.size(), (double)arg)); }
+
+        // Strings are copied, they need not outlive the error
+        error& operator<<(const char* arg) noexcept {
+            err_.append(arg);
+            return *this;
+        }
+
+        // Any string type providing data() and size()
+        template <class T>
+        auto operator<<(const T& arg) noexcept -> decltype(arg.data(), arg.size(), *this) {
+            err_.append(arg.data(), arg.size());
+            return *this;
+        }
+
+        error& operator<<(char arg) noexcept {
+            err_.append(1, arg);
+            return *this;
+        }
+    };
+#else
     // Streaming exception
     struct error : std::exception {
     private:
-        std::string err_;
+        error_string err_;
 
     public:
         error() = default;
 
-        error(std::string err)
+        error(error_string err)
         : err_(std::move(err))
         { }
 
+        error(const char* err)
+        : err_(err)
+        { }
+
         const char* what() const noexcept override
         { return err_.c_str(); }
 
         template <class T>
-        auto operator<<(T arg) -> decltype(std::to_string(arg), *this) {
-            err_.append(std::to_string(arg));
+        auto operator<<(T arg) -> decltype(detail::append_number(err_, arg), *this) {
+            detail::append_number(err_, arg);
             return *this;
         }
 
         template <class T>
-        auto operator<<(const T& arg) -> decltype(std::string().append(arg), *this) {
+        auto operator<<(const T& arg) -> decltype(err_.append(arg), *this) {
             err_.append(arg);
             return *this;
         }
@@ -45,6 +300,7 @@ namespace ard
             return *this;
         }
     };
+#endif
 
     // throw_exception
     [[noreturn]] inline void
@@ -54,5 +310,55 @@ namespace ard
         std::abort();
     }
 
+    // Error codes of library checks, used in place of messages with
+    // ARD_ERROR_CODES. Values are stable, tools/decode_error.py reads
+    // them together with the trailing comment.
+    enum class error_code : uint16_t {
+        string_view_subscript = 1,  // basic_string_view::operator[]: __pos >= size()
+        string_view_at = 2,         // basic_string_view::at: __pos >= size()
+        string_view_front = 3,      // basic_string_view::front: string is empty
+        string_view_back = 4,       // basic_string_view::back: string is empty
+    };
+
+    // Exception with error code and line instead of message
+    struct coded_error : std::exception {
+    private:
+        char buf_[32];
+
+    public:
+        error_code code;
+        unsigned line;
+
+        coded_error(error_code c, unsigned l) noexcept
+        : code(c), line(l)
+        {
+            static const char prefix[] = "ard::error E";
+            char* const last = buf_ + sizeof(buf_) - 1;
+            std::memcpy(buf_, prefix, sizeof(prefix) - 1);
+            char* p = std::to_chars(buf_ + sizeof(prefix) - 1, last, unsigned(code)).ptr;
+            *p++ = ' ';
+            *p++ = 'L';
+            p = std::to_chars(p, last, line).ptr;
+            *p = '\0';
+        }
+
+        const char* what() const noexcept override
+        { return buf_; }
+    };
+
+    // Out of line, so that each call site only passes two constants
+    [[noreturn]] __attribute__((noinline)) inline void
+    throw_error_code(error_code code, unsigned line)
+    { throw_exception(coded_error(code, line)); }
+
 } // namespace ard
 
+// Throw from library check. Message is streamed to ard::error, or
+// replaced by code (an error_code enumerator) with ARD_ERROR_CODES.
+#ifdef ARD_ERROR_CODES
+#define ARD_THROW_ERROR(code, msg) \
+    ::ard::throw_error_code(::ard::error_code::code, __LINE__)
+#else
+#define ARD_THROW_ERROR(code, msg) \
+    ::ard::throw_exception(::ard::error() << msg)
+#endif
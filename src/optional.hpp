@@ -28,6 +28,13 @@
 //
 // File version: 1.0.0
 //
+// Features:
+//  - and_then(), transform() and or_else() from C++23, the contained value
+//    is moved through the chain when optional is an rvalue
+//  - optional<T&> from C++26, a pointer with the interface of optional,
+//    assignment rebinds. transform() of function returning a reference
+//    gives optional<T&>
+//
 
 #pragma once
 
@@ -37,9 +44,11 @@
 
 #include "type_traits.hpp"
 #include "utility.hpp"
+#include "functional.hpp"
 #include "exception.hpp"
 
 #include <bits/enable_special_members.h>
+#include <bits/functional_hash.h>
 #include <cstdlib>
 
 namespace std
@@ -68,6 +77,16 @@ namespace std
     __throw_bad_optional_access()
     { ard::throw_exception(bad_optional_access()); }
 
+    template <typename _Tp>
+    constexpr bool __is_optional_v = false;
+    template <typename _Tp>
+    constexpr bool __is_optional_v<optional<_Tp>> = true;
+
+    // Function passed to optional<T>::transform, selects the constructor
+    // of optional<U> that constructs the value from its result.
+    template <typename _Fp>
+    struct _Optional_func { _Fp& _M_f; };
+
     // This class template manages construction/destruction of
     // the contained value for a std::optional.
     template <typename _Tp>
@@ -383,6 +402,19 @@ namespace std
             static_cast<_Dp*>(this)->_M_payload._M_engaged = true;
         }
 
+        // Construct from result of function, so that the temporary is
+        // elided instead of moved.
+        template <typename _Fn, typename _Up>
+        void
+        _M_apply(_Fn&& __f, _Up&& __x)
+        {
+            ::new
+                (std::__addressof(static_cast<_Dp*>(this)->_M_payload._M_payload))
+                _Stored_type(std::invoke(std::forward<_Fn>(__f),
+                    std::forward<_Up>(__x)));
+            static_cast<_Dp*>(this)->_M_payload._M_engaged = true;
+        }
+
         void
         _M_destruct() noexcept
         { static_cast<_Dp*>(this)->_M_payload._M_destroy(); }
@@ -917,7 +949,306 @@ namespace std
                 : static_cast<_Tp>(std::forward<_Up>(__u));
         }
 
+        // Monadic operations.
+        template <typename _Fn>
+        constexpr auto
+        and_then(_Fn&& __f) &
+        {
+            using _Up = __remove_cvref_t<invoke_result_t<_Fn, _Tp&>>;
+            static_assert(__is_optional_v<_Up>,
+                "the function passed to std::optional<T>::and_then "
+                "must return a std::optional");
+            if (this->_M_is_engaged())
+                return std::invoke(std::forward<_Fn>(__f), this->_M_get());
+            return _Up();
+        }
+
+        template <typename _Fn>
+        constexpr auto
+        and_then(_Fn&& __f) const&
+        {
+            using _Up = __remove_cvref_t<invoke_result_t<_Fn, const _Tp&>>;
+            static_assert(__is_optional_v<_Up>,
+                "the function passed to std::optional<T>::and_then "
+                "must return a std::optional");
+            if (this->_M_is_engaged())
+                return std::invoke(std::forward<_Fn>(__f), this->_M_get());
+            return _Up();
+        }
+
+        template <typename _Fn>
+        constexpr auto
+        and_then(_Fn&& __f) &&
+        {
+            using _Up = __remove_cvref_t<invoke_result_t<_Fn, _Tp>>;
+            static_assert(__is_optional_v<_Up>,
+                "the function passed to std::optional<T>::and_then "
+                "must return a std::optional");
+            if (this->_M_is_engaged())
+                return std::invoke(std::forward<_Fn>(__f),
+                    std::move(this->_M_get()));
+            return _Up();
+        }
+
+        template <typename _Fn>
+        constexpr auto
+        and_then(_Fn&& __f) const&&
+        {
+            using _Up = __remove_cvref_t<invoke_result_t<_Fn, const _Tp>>;
+            static_assert(__is_optional_v<_Up>,
+                "the function passed to std::optional<T>::and_then "
+                "must return a std::optional");
+            if (this->_M_is_engaged())
+                return std::invoke(std::forward<_Fn>(__f),
+                    std::move(this->_M_get()));
+            return _Up();
+        }
+
+        template <typename _Fn>
+        constexpr auto
+        transform(_Fn&& __f) &
+        {
+            using _Up = remove_cv_t<invoke_result_t<_Fn, _Tp&>>;
+            if (this->_M_is_engaged())
+                return optional<_Up>(_Optional_func<_Fn>{__f}, this->_M_get());
+            return optional<_Up>();
+        }
+
+        template <typename _Fn>
+        constexpr auto
+        transform(_Fn&& __f) const&
+        {
+            using _Up = remove_cv_t<invoke_result_t<_Fn, const _Tp&>>;
+            if (this->_M_is_engaged())
+                return optional<_Up>(_Optional_func<_Fn>{__f}, this->_M_get());
+            return optional<_Up>();
+        }
+
+        template <typename _Fn>
+        constexpr auto
+        transform(_Fn&& __f) &&
+        {
+            using _Up = remove_cv_t<invoke_result_t<_Fn, _Tp>>;
+            if (this->_M_is_engaged())
+                return optional<_Up>(_Optional_func<_Fn>{__f},
+                    std::move(this->_M_get()));
+            return optional<_Up>();
+        }
+
+        template <typename _Fn>
+        constexpr auto
+        transform(_Fn&& __f) const&&
+        {
+            using _Up = remove_cv_t<invoke_result_t<_Fn, const _Tp>>;
+            if (this->_M_is_engaged())
+                return optional<_Up>(_Optional_func<_Fn>{__f},
+                    std::move(this->_M_get()));
+            return optional<_Up>();
+        }
+
+        // Rvalue overload moves the value out, const&& binds to const&
+        // as in the standard.
+        template <typename _Fn>
+        constexpr optional
+        or_else(_Fn&& __f) const&
+        {
+            static_assert(is_copy_constructible<_Tp>::value);
+            static_assert(is_same<__remove_cvref_t<invoke_result_t<_Fn>>,
+                optional>::value,
+                "the function passed to std::optional<T>::or_else "
+                "must return a std::optional<T>");
+            if (this->_M_is_engaged())
+                return *this;
+            return std::forward<_Fn>(__f)();
+        }
+
+        template <typename _Fn>
+        constexpr optional
+        or_else(_Fn&& __f) &&
+        {
+            static_assert(is_move_constructible<_Tp>::value);
+            static_assert(is_same<__remove_cvref_t<invoke_result_t<_Fn>>,
+                optional>::value,
+                "the function passed to std::optional<T>::or_else "
+                "must return a std::optional<T>");
+            if (this->_M_is_engaged())
+                return std::move(*this);
+            return std::forward<_Fn>(__f)();
+        }
+
         void reset() noexcept { this->_M_reset(); }
+
+    private:
+        template <typename _Up>
+        friend class optional;
+
+        // Used by transform, value is the result of function. Function
+        // returning a reference gives optional<T&> instead.
+        template <typename _Fn, typename _Value>
+        explicit
+        optional(_Optional_func<_Fn> __f, _Value&& __v)
+        {
+            static_assert(!is_same<_Tp, in_place_t>::value
+                && !is_same<_Tp, nullopt_t>::value
+                && is_object<_Tp>::value && !is_array<_Tp>::value,
+                "the function passed to std::optional<T>::transform "
+                "must return a non-array object type");
+            this->_M_apply(std::forward<_Fn>(__f._M_f), std::forward<_Value>(__v));
+        }
+    };
+
+    /**
+      * @brief Optional reference (C++26), holds a pointer to the referred
+      * object. Assignment and emplace rebind, they never assign through.
+      */
+    template <typename _Tp>
+    class optional<_Tp&>
+    {
+        static_assert(!is_same<remove_cv_t<_Tp>, nullopt_t>::value);
+        static_assert(!is_same<remove_cv_t<_Tp>, in_place_t>::value);
+
+    private:
+        // SFINAE helpers
+        template <typename _Up>
+        using _Binds = enable_if_t<is_convertible<_Up*, _Tp*>::value, bool>;
+        template <typename _Up>
+        using _Binds_temporary = enable_if_t<__and_<
+            __not_<is_lvalue_reference<_Up>>,
+            is_convertible<remove_reference_t<_Up>*, _Tp*>>::value, bool>;
+
+        _Tp* _M_ptr = nullptr;
+
+    public:
+        using value_type = _Tp;
+
+        constexpr optional() noexcept = default;
+
+        constexpr optional(nullopt_t) noexcept { }
+
+        template <typename _Up, _Binds<_Up> = true>
+        constexpr
+        optional(_Up& __u) noexcept
+        : _M_ptr(std::__addressof(__u)) { }
+
+        // Would dangle
+        template <typename _Up, _Binds_temporary<_Up> = true>
+        optional(_Up&& __u) = delete;
+
+        template <typename _Up, _Binds<_Up> = true>
+        constexpr
+        optional(const optional<_Up&>& __u) noexcept
+        : _M_ptr(__u ? std::__addressof(*__u) : nullptr) { }
+
+        constexpr optional(const optional&) noexcept = default;
+
+        optional& operator=(const optional&) noexcept = default;
+
+        optional&
+        operator=(nullopt_t) noexcept
+        {
+            _M_ptr = nullptr;
+            return *this;
+        }
+
+        template <typename _Up, _Binds<_Up> = true>
+        _Tp&
+        emplace(_Up& __u) noexcept
+        {
+            _M_ptr = std::__addressof(__u);
+            return *_M_ptr;
+        }
+
+        void
+        swap(optional& __other) noexcept
+        { std::swap(_M_ptr, __other._M_ptr); }
+
+        // Observers, constness of optional does not apply to the object.
+        constexpr _Tp*
+        operator->() const noexcept
+        { return _M_ptr; }
+
+        constexpr _Tp&
+        operator*() const noexcept
+        {
+            __glibcxx_assert(_M_ptr);
+            return *_M_ptr;
+        }
+
+        constexpr explicit operator bool() const noexcept
+        { return _M_ptr; }
+
+        constexpr bool has_value() const noexcept
+        { return _M_ptr; }
+
+        constexpr _Tp&
+        value() const
+        {
+            if (_M_ptr)
+                return *_M_ptr;
+            __throw_bad_optional_access();
+        }
+
+        template <typename _Up>
+        constexpr remove_cv_t<_Tp>
+        value_or(_Up&& __u) const
+        {
+            static_assert(is_copy_constructible<remove_cv_t<_Tp>>::value);
+            static_assert(is_convertible<_Up&&, remove_cv_t<_Tp>>::value);
+
+            return _M_ptr ? *_M_ptr
+                : static_cast<remove_cv_t<_Tp>>(std::forward<_Up>(__u));
+        }
+
+        // Monadic operations.
+        template <typename _Fn>
+        constexpr auto
+        and_then(_Fn&& __f) const
+        {
+            using _Up = __remove_cvref_t<invoke_result_t<_Fn, _Tp&>>;
+            static_assert(__is_optional_v<_Up>,
+                "the function passed to std::optional<T&>::and_then "
+                "must return a std::optional");
+            if (_M_ptr)
+                return std::invoke(std::forward<_Fn>(__f), *_M_ptr);
+            return _Up();
+        }
+
+        template <typename _Fn>
+        constexpr auto
+        transform(_Fn&& __f) const
+        {
+            using _Up = remove_cv_t<invoke_result_t<_Fn, _Tp&>>;
+            if (_M_ptr)
+                return optional<_Up>(_Optional_func<_Fn>{__f}, *_M_ptr);
+            return optional<_Up>();
+        }
+
+        template <typename _Fn>
+        constexpr optional
+        or_else(_Fn&& __f) const
+        {
+            static_assert(is_same<__remove_cvref_t<invoke_result_t<_Fn>>,
+                optional>::value,
+                "the function passed to std::optional<T&>::or_else "
+                "must return a std::optional<T&>");
+            if (_M_ptr)
+                return *this;
+            return std::forward<_Fn>(__f)();
+        }
+
+        void reset() noexcept { _M_ptr = nullptr; }
+
+    private:
+        template <typename _Up>
+        friend class optional;
+
+        // Used by transform of function returning a reference.
+        template <typename _Fn, typename _Value>
+        explicit
+        optional(_Optional_func<_Fn> __f, _Value&& __v)
+        : _M_ptr(std::__addressof(std::invoke(std::forward<_Fn>(__f._M_f),
+            std::forward<_Value>(__v))))
+        { }
     };
 
     template <typename _Tp>
@@ -1147,6 +1478,12 @@ namespace std
     enable_if_t<!(is_move_constructible<_Tp>::value && is_swappable<_Tp>::value)>
     swap(optional<_Tp>&, optional<_Tp>&) = delete;
 
+    // Swaps the references, not the objects.
+    template <typename _Tp>
+    inline void
+    swap(optional<_Tp&>& __lhs, optional<_Tp&>& __rhs) noexcept
+    { __lhs.swap(__rhs); }
+
     template <typename _Tp>
     constexpr optional<decay_t<_Tp>>
     make_optional(_Tp&& __t)
@@ -1162,6 +1499,41 @@ namespace std
     make_optional(initializer_list<_Up> __il, _Args&&... __args)
     { return optional<_Tp> { in_place_t{}, __il, std::forward<_Args>(__args)... }; }
 
+    // Hash.
+
+    // vlta: hash of optional<T&> is the hash of T
+    template <typename _Tp, typename _Up = __remove_cvref_t<_Tp>,
+        bool = __poison_hash<_Up>::__enable_hash_call>
+    struct __optional_hash_call_base
+    {
+        size_t
+        operator()(const optional<_Tp>& __t) const
+        noexcept(noexcept(hash<_Up>{}(*__t)))
+        {
+            // We pick an arbitrary hash for disengaged optionals which hopefully
+            // usual values of _Tp won't typically hash to.
+            constexpr size_t __magic_disengaged_hash = static_cast<size_t>(-3333);
+            return __t ? hash<_Up>{}(*__t) : __magic_disengaged_hash;
+        }
+    };
+
+    template <typename _Tp, typename _Up>
+    struct __optional_hash_call_base<_Tp, _Up, false> {};
+
+    template <typename _Tp>
+    struct hash<optional<_Tp>>
+    : private __poison_hash<__remove_cvref_t<_Tp>>,
+      public __optional_hash_call_base<_Tp>
+    {
+        using result_type = size_t;
+        using argument_type = optional<_Tp>;
+    };
+
+    template <typename _Tp>
+    struct __is_fast_hash<hash<optional<_Tp>>>
+    : __is_fast_hash<hash<__remove_cvref_t<_Tp>>>
+    { };
+
 } // namespace std
 
 #endif // __cplusplus < 201703L
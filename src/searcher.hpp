@@ -0,0 +1,179 @@
+// Precompiled searchers for string_view
+// Vladimir Talybin (2021)
+//
+// File version: 1.0.0
+//
+// Searchers preprocess pattern once and may be built at compile time.
+// They follow protocol of std::boyer_moore_horspool_searcher and work
+// with std::search (see algorithm.hpp) and std::string_view::find:
+//
+//   constexpr ard::horspool_searcher content_length("Content-Length");
+//   size_t pos = header.find(content_length);
+//
+// Pattern is not copied, it must outlive the searcher.
+//
+//  - horspool_searcher, Boyer-Moore-Horspool with 256 byte shift table,
+//    best for longer patterns.
+//  - shift_or_searcher, bit-parallel (shift-or) with 1 KiB mask table,
+//    does not depend on pattern contents, best for short patterns. Only
+//    first 32 chars are matched bit-parallel, the rest is compared.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include "string_view.hpp"
+
+namespace ard
+{
+    namespace detail
+    {
+        // Compare n chars from it (but not past last) with pattern
+        template <class It>
+        constexpr bool equal_n(It it, It last, const char* pattern, size_t n) {
+            for (size_t i = 0; i < n; ++i, ++it)
+                if (it == last || *it != pattern[i])
+                    return false;
+            return true;
+        }
+
+        // Constexpr std::next and std::prev of C++17
+        template <class It>
+        constexpr It next_n(It it, size_t n) {
+            for (; n; --n)
+                ++it;
+            return it;
+        }
+
+        template <class It>
+        constexpr It prev_n(It it, size_t n) {
+            for (; n; --n)
+                --it;
+            return it;
+        }
+
+    } // namespace detail
+
+    // Boyer-Moore-Horspool searcher
+    struct horspool_searcher
+    {
+    private:
+        const char* pattern_;
+        size_t size_;
+        // Shift on mismatch per last char in window, capped at 255
+        unsigned char shift_[256];
+
+    public:
+        constexpr horspool_searcher(const char* first, const char* last) noexcept
+        : pattern_(first), size_(last - first), shift_{}
+        {
+            const unsigned char dflt = size_ < 255 ? size_ : 255;
+            for (size_t c = 0; c < 256; ++c)
+                shift_[c] = dflt;
+            for (size_t i = 0; i + 1 < size_; ++i) {
+                const size_t shift = size_ - 1 - i;
+                shift_[static_cast<unsigned char>(pattern_[i])] =
+                    shift < 255 ? shift : 255;
+            }
+        }
+
+        template <size_t N>
+        constexpr explicit horspool_searcher(const char (&pattern)[N]) noexcept
+        : horspool_searcher(pattern, pattern + N - 1)
+        { }
+
+        constexpr explicit horspool_searcher(std::string_view pattern) noexcept
+        : horspool_searcher(pattern.data(), pattern.data() + pattern.size())
+        { }
+
+        template <class RandomIt>
+        constexpr std::pair<RandomIt, RandomIt>
+        operator()(RandomIt first, RandomIt last) const
+        {
+            static_assert(std::is_base_of<std::random_access_iterator_tag,
+                typename std::iterator_traits<RandomIt>::iterator_category>::value,
+                "horspool_searcher requires random access iterators");
+
+            if (size_ == 0)
+                return { first, first };
+
+            const size_t len = last - first;
+            if (len < size_)
+                return { last, last };
+
+            const char back = pattern_[size_ - 1];
+            for (size_t i = 0; i <= len - size_; ) {
+                const char c = first[i + size_ - 1];
+                if (c == back && detail::equal_n(first + i, last, pattern_, size_ - 1))
+                    return { first + i, first + i + size_ };
+                i += shift_[static_cast<unsigned char>(c)];
+            }
+            return { last, last };
+        }
+    };
+
+    // Shift-or (bitap) searcher
+    struct shift_or_searcher
+    {
+    private:
+        const char* pattern_;
+        size_t size_;
+        // Bit i is cleared if char is at position i of pattern
+        uint32_t mask_[256];
+
+        static constexpr size_t max_bits = 32;
+
+    public:
+        constexpr shift_or_searcher(const char* first, const char* last) noexcept
+        : pattern_(first), size_(last - first), mask_{}
+        {
+            for (size_t c = 0; c < 256; ++c)
+                mask_[c] = ~uint32_t(0);
+            for (size_t i = 0; i < size_ && i < max_bits; ++i)
+                mask_[static_cast<unsigned char>(pattern_[i])] &= ~(uint32_t(1) << i);
+        }
+
+        template <size_t N>
+        constexpr explicit shift_or_searcher(const char (&pattern)[N]) noexcept
+        : shift_or_searcher(pattern, pattern + N - 1)
+        { }
+
+        constexpr explicit shift_or_searcher(std::string_view pattern) noexcept
+        : shift_or_searcher(pattern.data(), pattern.data() + pattern.size())
+        { }
+
+        template <class BidirIt>
+        constexpr std::pair<BidirIt, BidirIt>
+        operator()(BidirIt first, BidirIt last) const
+        {
+            static_assert(std::is_base_of<std::bidirectional_iterator_tag,
+                typename std::iterator_traits<BidirIt>::iterator_category>::value,
+                "shift_or_searcher requires bidirectional iterators");
+
+            if (size_ == 0)
+                return { first, first };
+
+            // Length of bit-parallel prefix and the rest to compare
+            const size_t head = size_ < max_bits ? size_ : max_bits;
+            const size_t tail = size_ - head;
+            const uint32_t found = uint32_t(1) << (head - 1);
+
+            uint32_t state = ~uint32_t(0);
+            for (BidirIt it = first; it != last; ++it) {
+                state = (state << 1) | mask_[static_cast<unsigned char>(*it)];
+                if ((state & found) == 0) {
+                    // Prefix ends at it
+                    const BidirIt end = detail::next_n(it, 1);
+                    if (detail::equal_n(end, last, pattern_ + head, tail)) {
+                        return { detail::prev_n(end, head),
+                            detail::next_n(end, tail) };
+                    }
+                }
+            }
+            return { last, last };
+        }
+    };
+
+} // namespace ard
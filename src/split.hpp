@@ -0,0 +1,184 @@
+// Lazy split of string_view
+// Vladimir Talybin (2021)
+//
+// File version: 1.0.0
+//
+// Range of pieces of string_view separated by a char, a string or any
+// char of ard::char_set. Pieces are views into the original string,
+// found one at a time while iterating, nothing is allocated:
+//
+//   for (std::string_view field : ard::split(line, ','))
+//       ...
+//
+// Pieces between adjacent delimiters, before leading delimiter and after
+// trailing delimiter are empty. Empty string gives one empty piece. Empty
+// string delimiter does not split. std::string and Particle String are
+// split in place, as their string_view.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include "string_view.hpp"
+#include "char_set.hpp"
+
+namespace ard
+{
+    namespace detail
+    {
+        // Position and length of the first delimiter at or after pos
+
+        template <class CharT, class Traits>
+        constexpr std::pair<size_t, size_t>
+        find_delim(std::basic_string_view<CharT, Traits> str, CharT delim, size_t pos) noexcept
+        { return { str.find(delim, pos), 1 }; }
+
+        template <class CharT, class Traits>
+        constexpr std::pair<size_t, size_t>
+        find_delim(std::basic_string_view<CharT, Traits> str,
+            std::basic_string_view<CharT, Traits> delim, size_t pos) noexcept
+        {
+            if (delim.empty())
+                return { str.npos, 0 };
+            return { str.find(delim, pos), delim.size() };
+        }
+
+        constexpr std::pair<size_t, size_t>
+        find_delim(std::string_view str, const char_set& delim, size_t pos) noexcept
+        {
+#if __cplusplus < 201703L
+            return { str.find_first_of(delim, pos), 1 };
+#else
+            for (; pos < str.size(); ++pos)
+                if (delim.test(str[pos]))
+                    return { pos, 1 };
+            return { str.npos, 1 };
+#endif
+        }
+
+    } // namespace detail
+
+    template <class CharT, class Traits, class Delim>
+    struct basic_split_view
+    {
+        using view_type = std::basic_string_view<CharT, Traits>;
+
+    private:
+        view_type str_;
+        Delim delim_;
+
+    public:
+        struct iterator
+        {
+            // Current piece is kept in the iterator, references to it are
+            // valid until the iterator is advanced or destroyed
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = view_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const view_type*;
+            using reference = const view_type&;
+
+        private:
+            // Null at end
+            const basic_split_view* parent_ = nullptr;
+            view_type piece_;
+            // Length of delimiter after piece, 0 if piece is the last one
+            size_t delim_len_ = 0;
+
+            constexpr void find(size_t pos) noexcept {
+                const view_type& str = parent_->str_;
+                const auto d = detail::find_delim(str, parent_->delim_, pos);
+                if (d.first == str.npos) {
+                    piece_ = str.substr(pos);
+                    delim_len_ = 0;
+                }
+                else {
+                    piece_ = str.substr(pos, d.first - pos);
+                    delim_len_ = d.second;
+                }
+            }
+
+            friend basic_split_view;
+
+        public:
+            constexpr iterator() noexcept = default;
+
+            constexpr reference operator*() const noexcept
+            { return piece_; }
+
+            constexpr pointer operator->() const noexcept
+            { return &piece_; }
+
+            constexpr iterator& operator++() noexcept {
+                if (delim_len_ == 0)
+                    *this = iterator();
+                else {
+                    const size_t pos = piece_.data() - parent_->str_.data();
+                    find(pos + piece_.size() + delim_len_);
+                }
+                return *this;
+            }
+
+            constexpr iterator operator++(int) noexcept {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            friend constexpr bool operator==(const iterator& a, const iterator& b) noexcept
+            {
+                return a.parent_ == b.parent_ &&
+                    a.piece_.data() == b.piece_.data();
+            }
+
+            friend constexpr bool operator!=(const iterator& a, const iterator& b) noexcept
+            { return !(a == b); }
+        };
+
+        constexpr basic_split_view(view_type str, Delim delim) noexcept
+        : str_(str), delim_(delim)
+        { }
+
+        constexpr iterator begin() const noexcept {
+            iterator it;
+            it.parent_ = this;
+            it.find(0);
+            return it;
+        }
+
+        constexpr iterator end() const noexcept
+        { return iterator(); }
+    };
+
+    // Split str at each delim char
+    template <class CharT, class Traits>
+    constexpr basic_split_view<CharT, Traits, CharT>
+    split(std::basic_string_view<CharT, Traits> str, CharT delim) noexcept
+    { return { str, delim }; }
+
+    // Split str at each occurrence of delim string
+    template <class CharT, class Traits>
+    constexpr basic_split_view<CharT, Traits, std::basic_string_view<CharT, Traits>>
+    split(std::basic_string_view<CharT, Traits> str,
+        std::type_identity_t<std::basic_string_view<CharT, Traits>> delim) noexcept
+    { return { str, delim }; }
+
+    // Split str at each char of delim set
+    constexpr basic_split_view<char, std::char_traits<char>, char_set>
+    split(std::string_view str, const char_set& delim) noexcept
+    { return { str, delim }; }
+
+    // Split std::string, Particle String or alike, see to_string_view().
+    // The string must outlive the split, temporary is not accepted.
+    template <class S, class Delim>
+    constexpr auto split(const S& str, const Delim& delim) noexcept
+        -> decltype(split(to_string_view(str), delim))
+    { return split(to_string_view(str), delim); }
+
+    template <class S, class Delim>
+    constexpr auto split(const S&& str, const Delim& delim) noexcept
+        -> decltype(split(to_string_view(str), delim)) = delete;
+
+} // namespace ard
@@ -30,10 +30,88 @@
 //
 // Features:
 //  - Includes starts_with(), ends_with() from C++20 and contains() from C++23
+//  - find() of a string in string_view compares blocks of chars at once
+//    (SSE2 on x86, machine word elsewhere) when not in constant expression
+//  - find_first_of() and family look up chars of string_view in a 256 bit
+//    table, they also accept precompiled ard::char_set
+//  - find() accepts precompiled searcher (ard::horspool_searcher and others)
+//  - ard::hash() and "..."_hash literal, constexpr hash for switch on string
+//  - string_view from std::string, Particle String and alike (c_str() and
+//    length()), ard::append() and ard::compare() of these with string_view
+//
+// Configuration:
+//  - ARD_STRING_VIEW_FAST_HASH, if defined, std::hash of string_view types
+//    uses ard::detail::hash_chars (FNV-1a over 32-bit words) instead of
+//    std::_Hash_impl and is marked fast, so unordered containers do not
+//    cache hash codes in nodes.
 //
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include "type_traits.hpp"
+
+namespace ard
+{
+    namespace detail
+    {
+        template <size_t>
+        struct hash_traits;
+
+        template <>
+        struct hash_traits<4> {
+            static constexpr uint32_t offset = 2166136261u;
+            static constexpr uint32_t prime = 16777619u;
+
+            // Final mix of murmur3
+            static constexpr uint32_t mix(uint32_t h) noexcept {
+                h ^= h >> 16;
+                h *= 0x85ebca6bu;
+                h ^= h >> 13;
+                h *= 0xc2b2ae35u;
+                return h ^ (h >> 16);
+            }
+        };
+
+        template <>
+        struct hash_traits<8> {
+            static constexpr uint64_t offset = 14695981039346656037ull;
+            static constexpr uint64_t prime = 1099511628211ull;
+
+            static constexpr uint64_t mix(uint64_t h) noexcept {
+                h ^= h >> 33;
+                h *= 0xff51afd7ed558ccdull;
+                h ^= h >> 33;
+                h *= 0xc4ceb9fe1a85ec53ull;
+                return h ^ (h >> 33);
+            }
+        };
+
+        // FNV-1a over 32-bit little-endian words of str, then mixed.
+        // Usable in constant expressions, at run time compiler merges the
+        // four char loads into one word load.
+        constexpr size_t hash_chars(const char* str, size_t n) noexcept
+        {
+            using traits = hash_traits<sizeof(size_t)>;
+
+            size_t h = traits::offset ^ n;
+            for (; n >= 4; n -= 4, str += 4) {
+                const uint32_t w =
+                    uint32_t(static_cast<unsigned char>(str[0])) |
+                    uint32_t(static_cast<unsigned char>(str[1])) << 8 |
+                    uint32_t(static_cast<unsigned char>(str[2])) << 16 |
+                    uint32_t(static_cast<unsigned char>(str[3])) << 24;
+                h = (h ^ w) * traits::prime;
+            }
+            for (; n; --n, ++str)
+                h = (h ^ static_cast<unsigned char>(*str)) * traits::prime;
+            return traits::mix(h);
+        }
+
+    } // namespace detail
+} // namespace ard
+
 #if __cplusplus >= 201703L
 #include <string_view>
 #else
@@ -42,9 +120,198 @@
 #include <iterator>
 #include "type_traits.hpp"
 #include "exception.hpp"
+#include "char_set.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace std
 {
+    namespace __detail {
+        namespace __string_view
+        {
+            // Naive search of __str in __s starting at __pos, used at
+            // compile time and for character types other than char
+            template <class _Traits, class _CharT>
+            constexpr size_t
+            __find(const _CharT* __s, size_t __len, size_t __pos,
+                const _CharT* __str, size_t __n, false_type) noexcept
+            {
+                if (__n <= __len) {
+                    for (; __pos <= __len - __n; ++__pos)
+                        if (_Traits::eq(__s[__pos], __str[0])
+                            && _Traits::compare(__s + __pos + 1,
+                                __str + 1, __n - 1) == 0)
+                            return __pos;
+                }
+                return size_t(-1);
+            }
+
+            // Search of __str in __s starting at __pos. Possible starts are
+            // found by comparing a block of __s with the first and the last
+            // char of __str at once, only these are compared in full.
+            template <class _Traits>
+            inline size_t
+            __find(const char* __s, size_t __len, size_t __pos,
+                const char* __str, size_t __n, true_type) noexcept
+            {
+                if (__n > __len || __pos > __len - __n)
+                    return size_t(-1);
+
+                if (__n == 1) {
+                    const char* __p = _Traits::find(__s + __pos, __len - __pos, __str[0]);
+                    return __p ? size_t(__p - __s) : size_t(-1);
+                }
+
+                const char* __p = __s + __pos;
+                // One past the last possible start
+                const char* const __end = __s + __len - __n + 1;
+                const char __first = __str[0];
+                const char __last = __str[__n - 1];
+
+#if defined(__SSE2__)
+                const __m128i __vfirst = _mm_set1_epi8(__first);
+                const __m128i __vlast = _mm_set1_epi8(__last);
+
+                for (; __end - __p >= 16; __p += 16) {
+                    const __m128i __bfirst = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(__p));
+                    const __m128i __blast = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(__p + __n - 1));
+
+                    unsigned __mask = _mm_movemask_epi8(_mm_and_si128(
+                        _mm_cmpeq_epi8(__bfirst, __vfirst),
+                        _mm_cmpeq_epi8(__blast, __vlast)));
+
+                    for (; __mask; __mask &= __mask - 1) {
+                        const char* __c = __p + __builtin_ctz(__mask);
+                        if (_Traits::compare(__c + 1, __str + 1, __n - 2) == 0)
+                            return __c - __s;
+                    }
+                }
+#elif __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+                // Word is 32 bits on Cortex-M, which has no SIMD for this
+                using __word = unsigned long;
+                constexpr __word __ones = __word(-1) / 0xff;
+                const __word __wfirst = __ones * static_cast<unsigned char>(__first);
+                const __word __wlast = __ones * static_cast<unsigned char>(__last);
+
+                for (; size_t(__end - __p) >= sizeof(__word); __p += sizeof(__word)) {
+                    __word __bfirst, __blast;
+                    __builtin_memcpy(&__bfirst, __p, sizeof(__word));
+                    __builtin_memcpy(&__blast, __p + __n - 1, sizeof(__word));
+
+                    // Zero bytes mark matches of both chars. Bytes above
+                    // a zero byte may be marked falsely, so compare all.
+                    const __word __x = (__bfirst ^ __wfirst) | (__blast ^ __wlast);
+                    __word __mask = (__x - __ones) & ~__x & (__ones << 7);
+
+                    for (; __mask; __mask &= __mask - 1) {
+                        const char* __c = __p + __builtin_ctzl(__mask) / 8;
+                        if (_Traits::compare(__c, __str, __n) == 0)
+                            return __c - __s;
+                    }
+                }
+#endif
+                for (; __p != __end; ++__p)
+                    if (__p[0] == __first && __p[__n - 1] == __last
+                        && _Traits::compare(__p + 1, __str + 1, __n - 2) == 0)
+                        return __p - __s;
+
+                return size_t(-1);
+            }
+
+            // Types providing c_str() and length(), like std::string and
+            // Particle String
+            template <class _Str, class _CharT>
+            using __c_str_t = enable_if_t<is_convertible<
+                decltype(std::declval<const _Str&>().c_str()), const _CharT*>::value,
+                decltype(std::declval<const _Str&>().length())>;
+
+            // First position from __pos where char is (_Match) or is not
+            // (!_Match) in __set
+            template <bool _Match>
+            constexpr size_t
+            __find_first_of(const char* __s, size_t __len, size_t __pos,
+                const ard::char_set& __set) noexcept
+            {
+                for (; __pos < __len; ++__pos)
+                    if (__set.test(__s[__pos]) == _Match)
+                        return __pos;
+                return size_t(-1);
+            }
+
+            // Last position up to __pos where char is (_Match) or is not
+            // (!_Match) in __set
+            template <bool _Match>
+            constexpr size_t
+            __find_last_of(const char* __s, size_t __len, size_t __pos,
+                const ard::char_set& __set) noexcept
+            {
+                if (__len) {
+                    if (--__len > __pos)
+                        __len = __pos;
+                    do {
+                        if (__set.test(__s[__len]) == _Match)
+                            return __len;
+                    }
+                    while (__len-- != 0);
+                }
+                return size_t(-1);
+            }
+
+            // Same with chars of __str, these search __str for each char
+            template <bool _Match, class _Traits, class _CharT>
+            constexpr size_t
+            __find_first_of(const _CharT* __s, size_t __len, size_t __pos,
+                const _CharT* __str, size_t __n, false_type) noexcept
+            {
+                for (; __pos < __len; ++__pos)
+                    if (bool(_Traits::find(__str, __n, __s[__pos])) == _Match)
+                        return __pos;
+                return size_t(-1);
+            }
+
+            template <bool _Match, class _Traits, class _CharT>
+            constexpr size_t
+            __find_last_of(const _CharT* __s, size_t __len, size_t __pos,
+                const _CharT* __str, size_t __n, false_type) noexcept
+            {
+                if (__len) {
+                    if (--__len > __pos)
+                        __len = __pos;
+                    do {
+                        if (bool(_Traits::find(__str, __n, __s[__len])) == _Match)
+                            return __len;
+                    }
+                    while (__len-- != 0);
+                }
+                return size_t(-1);
+            }
+
+            // and these build a lookup table of __str first
+            template <bool _Match, class _Traits>
+            constexpr size_t
+            __find_first_of(const char* __s, size_t __len, size_t __pos,
+                const char* __str, size_t __n, true_type) noexcept
+            {
+                return __find_first_of<_Match>(
+                    __s, __len, __pos, ard::char_set(__str, __n));
+            }
+
+            template <bool _Match, class _Traits>
+            constexpr size_t
+            __find_last_of(const char* __s, size_t __len, size_t __pos,
+                const char* __str, size_t __n, true_type) noexcept
+            {
+                return __find_last_of<_Match>(
+                    __s, __len, __pos, ard::char_set(__str, __n));
+            }
+
+        } // namespace __string_view
+    } // namespace __detail
+
     template <class _CharT, class _Traits = std::char_traits<_CharT>>
     struct basic_string_view
     {
@@ -88,6 +355,15 @@ namespace std
         : _M_len{__len}, _M_str{__str}
         { }
 
+        // vlta: from std::string, Particle String and other types with
+        // c_str() and length(), without scanning for null terminator
+        template <class _Str,
+            class = __detail::__string_view::__c_str_t<_Str, _CharT>>
+        constexpr
+        basic_string_view(const _Str& __str) noexcept
+        : _M_len{size_type(__str.length())}, _M_str{__str.c_str()}
+        { }
+
         constexpr basic_string_view&
         operator=(const basic_string_view&) noexcept = default;
 
@@ -151,7 +427,7 @@ namespace std
         operator[](size_type __pos) const {
             if (__pos < _M_len)
                 return *(this->_M_str + __pos);
-            ard::throw_exception(ard::error() <<
+            ARD_THROW_ERROR(string_view_subscript,
                 "basic_string_view::operator[]: __pos "
                 "(which is " << __pos << ") >= size() "
                 "(which is " << this->size() << ')'
@@ -162,7 +438,7 @@ namespace std
         at(size_type __pos) const {
             if (__pos < _M_len)
                 return *(this->_M_str + __pos);
-            ard::throw_exception(ard::error() <<
+            ARD_THROW_ERROR(string_view_at,
                 "basic_string_view::at: __pos "
                 "(which is " << __pos << ") >= size() "
                 "(which is " << this->size() << ')'
@@ -173,16 +449,16 @@ namespace std
         front() const {
             if (this->_M_len > 0)
                 return *this->_M_str;
-            ard::throw_exception(
-                ard::error("basic_string_view::front: string is empty"));
+            ARD_THROW_ERROR(string_view_front,
+                "basic_string_view::front: string is empty");
         }
 
         constexpr const_reference
         back() const {
             if (this->_M_len > 0)
                 return *(this->_M_str + this->_M_len - 1);
-            ard::throw_exception(
-                ard::error("basic_string_view::back: string is empty"));
+            ARD_THROW_ERROR(string_view_back,
+                "basic_string_view::back: string is empty");
         }
 
         constexpr const_pointer
@@ -326,6 +602,26 @@ namespace std
         find(const _CharT* __str, size_type __pos = 0) const noexcept
         { return this->find(__str, __pos, traits_type::length(__str)); }
 
+        // vlta: search with precompiled searcher (see searcher.hpp)
+        template <class _Searcher, class = decltype(std::declval<const _Searcher&>()(
+            std::declval<const_pointer>(), std::declval<const_pointer>()))>
+        constexpr size_type
+        find(const _Searcher& __searcher, size_type __pos = 0) const {
+            if (__pos > this->_M_len)
+                return npos;
+            const_pointer __end = this->_M_str + this->_M_len;
+            const_pointer __p = __searcher(this->_M_str + __pos, __end).first;
+            if (__p != __end)
+                return size_type(__p - this->_M_str);
+            if (__pos < this->_M_len)
+                return npos;
+            // Only empty pattern matches at the end, it also matches
+            // at start of a probe char, where other patterns do not
+            const _CharT __c{};
+            const auto __r = __searcher(&__c, &__c + 1);
+            return __r.first == &__c && __r.second == &__c ? __pos : npos;
+        }
+
         constexpr size_type
         rfind(basic_string_view __str, size_type __pos = npos) const noexcept
         { return this->rfind(__str._M_str, __pos, __str._M_len); }
@@ -355,6 +651,15 @@ namespace std
         find_first_of(const _CharT* __str, size_type __pos = 0) const noexcept
         { return this->find_first_of(__str, __pos, traits_type::length(__str)); }
 
+        // vlta: search with precompiled set of chars
+        constexpr size_type
+        find_first_of(const ard::char_set& __set, size_type __pos = 0) const noexcept {
+            static_assert(std::is_same<_CharT, char>::value,
+                "ard::char_set is a set of char");
+            return __detail::__string_view::__find_first_of<true>(
+                this->_M_str, this->_M_len, __pos, __set);
+        }
+
         constexpr size_type
         find_last_of(basic_string_view __str, size_type __pos = npos) const noexcept
         { return this->find_last_of(__str._M_str, __pos, __str._M_len); }
@@ -370,6 +675,15 @@ namespace std
         find_last_of(const _CharT* __str, size_type __pos = npos) const noexcept
         { return this->find_last_of(__str, __pos, traits_type::length(__str)); }
 
+        // vlta: search with precompiled set of chars
+        constexpr size_type
+        find_last_of(const ard::char_set& __set, size_type __pos = npos) const noexcept {
+            static_assert(std::is_same<_CharT, char>::value,
+                "ard::char_set is a set of char");
+            return __detail::__string_view::__find_last_of<true>(
+                this->_M_str, this->_M_len, __pos, __set);
+        }
+
         constexpr size_type
         find_first_not_of(basic_string_view __str, size_type __pos = 0) const noexcept
         { return this->find_first_not_of(__str._M_str, __pos, __str._M_len); }
@@ -384,6 +698,15 @@ namespace std
         find_first_not_of(const _CharT* __str, size_type __pos = 0) const noexcept
         { return this->find_first_not_of(__str, __pos, traits_type::length(__str)); }
 
+        // vlta: search with precompiled set of chars
+        constexpr size_type
+        find_first_not_of(const ard::char_set& __set, size_type __pos = 0) const noexcept {
+            static_assert(std::is_same<_CharT, char>::value,
+                "ard::char_set is a set of char");
+            return __detail::__string_view::__find_first_of<false>(
+                this->_M_str, this->_M_len, __pos, __set);
+        }
+
         constexpr size_type
         find_last_not_of(basic_string_view __str, size_type __pos = npos) const noexcept
         { return this->find_last_not_of(__str._M_str, __pos, __str._M_len); }
@@ -398,6 +721,15 @@ namespace std
         find_last_not_of(const _CharT* __str, size_type __pos = npos) const noexcept
         { return this->find_last_not_of(__str, __pos, traits_type::length(__str)); }
 
+        // vlta: search with precompiled set of chars
+        constexpr size_type
+        find_last_not_of(const ard::char_set& __set, size_type __pos = npos) const noexcept {
+            static_assert(std::is_same<_CharT, char>::value,
+                "ard::char_set is a set of char");
+            return __detail::__string_view::__find_last_of<false>(
+                this->_M_str, this->_M_len, __pos, __set);
+        }
+
     private:
         static constexpr int
         _S_compare(size_type __n1, size_type __n2) noexcept
@@ -414,6 +746,11 @@ namespace std
         const _CharT* _M_str;
     };
 
+    // vlta: definition of static member, it is not inline in C++14
+    template <typename _CharT, typename _Traits>
+    constexpr typename basic_string_view<_CharT, _Traits>::size_type
+    basic_string_view<_CharT, _Traits>::npos;
+
     template <typename _CharT, typename _Traits>
     constexpr typename basic_string_view<_CharT, _Traits>::size_type
     basic_string_view<_CharT, _Traits>::
@@ -422,14 +759,15 @@ namespace std
         if (__n == 0)
             return __pos <= this->_M_len ? __pos : npos;
 
-        if (__n <= this->_M_len) {
-            for (; __pos <= this->_M_len - __n; ++__pos)
-                if (traits_type::eq(this->_M_str[__pos], __str[0])
-                    && traits_type::compare(this->_M_str + __pos + 1,
-                        __str + 1, __n - 1) == 0)
-                    return __pos;
-        }
-        return npos;
+#ifdef _ARD_HAVE_IS_CONSTANT_EVALUATED
+        // vlta: block-wise search for char at run time
+        if (!std::is_constant_evaluated())
+            return __detail::__string_view::__find<_Traits>(
+                this->_M_str, this->_M_len, __pos, __str, __n,
+                std::is_same<_Traits, char_traits<char>>{});
+#endif
+        return __detail::__string_view::__find<_Traits>(
+            this->_M_str, this->_M_len, __pos, __str, __n, false_type{});
     }
 
     template <typename _CharT, typename _Traits>
@@ -485,13 +823,10 @@ namespace std
     find_first_of(
         const _CharT* __str, size_type __pos, size_type __n) const noexcept
     {
-        for (; __n && __pos < this->_M_len; ++__pos) {
-            const _CharT* __p =
-                traits_type::find(__str, __n, this->_M_str[__pos]);
-            if (__p)
-                return __pos;
-        }
-        return npos;
+        // vlta: lookup table for char
+        return __detail::__string_view::__find_first_of<true, _Traits>(
+            this->_M_str, this->_M_len, __pos, __str, __n,
+            std::is_same<_Traits, char_traits<char>>{});
     }
 
     template <typename _CharT, typename _Traits>
@@ -500,17 +835,10 @@ namespace std
     find_last_of(
         const _CharT* __str, size_type __pos, size_type __n) const noexcept
     {
-        size_type __size = this->size();
-        if (__size && __n) {
-            if (--__size > __pos)
-                __size = __pos;
-            do {
-                if (traits_type::find(__str, __n, this->_M_str[__size]))
-                    return __size;
-            }
-            while (__size-- != 0);
-        }
-        return npos;
+        // vlta: lookup table for char
+        return __detail::__string_view::__find_last_of<true, _Traits>(
+            this->_M_str, this->_M_len, __pos, __str, __n,
+            std::is_same<_Traits, char_traits<char>>{});
     }
 
     template <typename _CharT, typename _Traits>
@@ -519,10 +847,10 @@ namespace std
     find_first_not_of(
         const _CharT* __str, size_type __pos, size_type __n) const noexcept
     {
-        for (; __pos < this->_M_len; ++__pos)
-            if (!traits_type::find(__str, __n, this->_M_str[__pos]))
-                return __pos;
-        return npos;
+        // vlta: lookup table for char
+        return __detail::__string_view::__find_first_of<false, _Traits>(
+            this->_M_str, this->_M_len, __pos, __str, __n,
+            std::is_same<_Traits, char_traits<char>>{});
     }
 
     template <typename _CharT, typename _Traits>
@@ -542,17 +870,10 @@ namespace std
     find_last_not_of(
         const _CharT* __str, size_type __pos, size_type __n) const noexcept
     {
-        size_type __size = this->_M_len;
-        if (__size) {
-            if (--__size > __pos)
-                __size = __pos;
-            do {
-                if (!traits_type::find(__str, __n, this->_M_str[__size]))
-                    return __size;
-            }
-            while (__size--);
-        }
-        return npos;
+        // vlta: lookup table for char
+        return __detail::__string_view::__find_last_of<false, _Traits>(
+            this->_M_str, this->_M_len, __pos, __str, __n,
+            std::is_same<_Traits, char_traits<char>>{});
     }
 
     template <typename _CharT, typename _Traits>
@@ -719,17 +1040,32 @@ namespace std
     template <class _Tp>
     struct hash;
 
+    // vlta: FNV-1a over words is cheap enough to not cache in nodes
+#ifdef ARD_STRING_VIEW_FAST_HASH
+    inline size_t
+    __string_view_hash(const void* __ptr, size_t __len) noexcept
+    { return ard::detail::hash_chars(static_cast<const char*>(__ptr), __len); }
+
+    using __string_view_fast_hash = std::true_type;
+#else
+    inline size_t
+    __string_view_hash(const void* __ptr, size_t __len) noexcept
+    { return std::_Hash_impl::hash(__ptr, __len); }
+
+    using __string_view_fast_hash = std::false_type;
+#endif
+
     template <>
     struct hash<string_view>
     : public __hash_base<size_t, string_view>
     {
         size_t
         operator()(const string_view& __str) const noexcept
-        { return std::_Hash_impl::hash(__str.data(), __str.length()); }
+        { return __string_view_hash(__str.data(), __str.length()); }
     };
 
     template <>
-    struct __is_fast_hash<hash<string_view>> : std::false_type
+    struct __is_fast_hash<hash<string_view>> : __string_view_fast_hash
     { };
 
 #ifdef _GLIBCXX_USE_WCHAR_T
@@ -739,12 +1075,12 @@ namespace std
     {
         size_t
         operator()(const wstring_view& __s) const noexcept
-        { return std::_Hash_impl::hash(
+        { return __string_view_hash(
             __s.data(), __s.length() * sizeof(wchar_t)); }
     };
 
     template <>
-    struct __is_fast_hash<hash<wstring_view>> : std::false_type
+    struct __is_fast_hash<hash<wstring_view>> : __string_view_fast_hash
     { };
 #endif
 
@@ -755,11 +1091,11 @@ namespace std
     {
         size_t
         operator()(const u8string_view& __str) const noexcept
-        { return std::_Hash_impl::hash(__str.data(), __str.length()); }
+        { return __string_view_hash(__str.data(), __str.length()); }
     };
 
     template <>
-    struct __is_fast_hash<hash<u8string_view>> : std::false_type
+    struct __is_fast_hash<hash<u8string_view>> : __string_view_fast_hash
     { };
 #endif
 
@@ -769,12 +1105,12 @@ namespace std
     {
         size_t
         operator()(const u16string_view& __s) const noexcept
-        { return std::_Hash_impl::hash(
+        { return __string_view_hash(
             __s.data(), __s.length() * sizeof(char16_t)); }
     };
 
     template <>
-    struct __is_fast_hash<hash<u16string_view>> : std::false_type
+    struct __is_fast_hash<hash<u16string_view>> : __string_view_fast_hash
     { };
 
     template <>
@@ -783,14 +1119,15 @@ namespace std
     {
         size_t
         operator()(const u32string_view& __s) const noexcept
-        { return std::_Hash_impl::hash(
+        { return __string_view_hash(
             __s.data(), __s.length() * sizeof(char32_t)); }
     };
 
     template <>
-    struct __is_fast_hash<hash<u32string_view>> : std::false_type
+    struct __is_fast_hash<hash<u32string_view>> : __string_view_fast_hash
     { };
 
+
     inline namespace literals
     {
         inline namespace string_view_literals
@@ -829,3 +1166,137 @@ namespace std
 
 #endif // __cplusplus < 201703L
 
+namespace ard
+{
+    // Hash of string usable in constant expressions, allows switch on
+    // string. Different strings may have same hash, so compare string in
+    // case label. Collision of two labels is caught by compiler as
+    // duplicate case value.
+    //
+    //   using namespace ard::literals;
+    //
+    //   switch (ard::hash(cmd)) {
+    //   case "reset"_hash:
+    //       if (cmd == "reset")
+    //           reset();
+    //       break;
+    //   ...
+    //
+    constexpr size_t hash(std::string_view str) noexcept
+    { return detail::hash_chars(str.data(), str.size()); }
+
+    // String together with its hash. Converts to the hash, so it works as
+    // case label, and matches() compares the string, so each label is
+    // spelled once:
+    //
+    //   constexpr auto reset_cmd = "reset"_cmd;
+    //
+    //   switch (ard::hash(cmd)) {
+    //   case reset_cmd:
+    //       if (reset_cmd.matches(cmd))
+    //           reset();
+    //       break;
+    //   ...
+    //
+    struct hashed_string
+    {
+    private:
+        std::string_view str_;
+        size_t hash_;
+
+    public:
+        constexpr explicit hashed_string(std::string_view str) noexcept
+        : str_(str), hash_(ard::hash(str))
+        { }
+
+        constexpr std::string_view view() const noexcept
+        { return str_; }
+
+        constexpr size_t hash() const noexcept
+        { return hash_; }
+
+        constexpr operator size_t() const noexcept
+        { return hash_; }
+
+        // True if str is this string, not just a string with same hash
+        bool matches(std::string_view str) const noexcept
+        { return str == str_; }
+
+        // Hash of str is given, as in switch, compared first
+        bool matches(std::string_view str, size_t str_hash) const noexcept
+        { return str_hash == hash_ && str == str_; }
+    };
+
+    // View of std::string, Particle String or other type providing
+    // c_str() and length(), length is not scanned for
+    template <class S>
+    constexpr auto to_string_view(const S& str) noexcept
+        -> decltype(std::string_view(str.c_str(), size_t(str.length())))
+    { return std::string_view(str.c_str(), size_t(str.length())); }
+
+    namespace detail
+    {
+        template <class S>
+        using append_t = decltype(
+            std::declval<S&>().append(std::declval<const char*>(), size_t()));
+
+        template <class S>
+        using concat_t = decltype(
+            std::declval<S&>().concat(std::declval<const char*>(), 0u));
+
+        template <class S>
+        using push_char_t = decltype(std::declval<S&>().reserve(0u),
+            std::declval<S&>().length(), std::declval<S&>() += char());
+
+    } // namespace detail
+
+    // Append string_view to std::string, Particle String or alike, without
+    // temporary string
+
+    // std::string
+    template <class S>
+    std::enable_if_t<std::is_detected<detail::append_t, S>::value, S&>
+    append(S& str, std::string_view sv) {
+        str.append(sv.data(), sv.size());
+        return str;
+    }
+
+    // String with public concat(const char*, unsigned)
+    template <class S>
+    std::enable_if_t<!std::is_detected<detail::append_t, S>::value &&
+        std::is_detected<detail::concat_t, S>::value, S&>
+    append(S& str, std::string_view sv) {
+        str.concat(sv.data(), unsigned(sv.size()));
+        return str;
+    }
+
+    // Other String, reserve once and append by char
+    template <class S>
+    std::enable_if_t<!std::is_detected<detail::append_t, S>::value &&
+        !std::is_detected<detail::concat_t, S>::value &&
+        std::is_detected<detail::push_char_t, S>::value, S&>
+    append(S& str, std::string_view sv) {
+        str.reserve(str.length() + sv.size());
+        for (char c : sv)
+            str += c;
+        return str;
+    }
+
+    // Compare std::string, Particle String or alike with string_view,
+    // without temporary string
+    template <class S>
+    constexpr auto compare(const S& str, std::string_view sv) noexcept
+        -> decltype(to_string_view(str).compare(sv))
+    { return to_string_view(str).compare(sv); }
+
+    inline namespace literals
+    {
+        constexpr size_t operator""_hash(const char* str, size_t n) noexcept
+        { return detail::hash_chars(str, n); }
+
+        constexpr hashed_string operator""_cmd(const char* str, size_t n) noexcept
+        { return hashed_string(std::string_view(str, n)); }
+
+    } // namespace literals
+} // namespace ard
+
@@ -139,6 +139,22 @@ namespace std
     template <class _Tp>
     using remove_cvref_t = typename remove_cvref<_Tp>::type;
 
+    // GCC 9 has the builtin but not __has_builtin (added in GCC 10)
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define _ARD_HAVE_IS_CONSTANT_EVALUATED 1
+#endif
+#elif defined(__GNUC__) && __GNUC__ >= 9
+#define _ARD_HAVE_IS_CONSTANT_EVALUATED 1
+#endif
+
+#ifdef _ARD_HAVE_IS_CONSTANT_EVALUATED
+    /// \see https://en.cppreference.com/w/cpp/types/is_constant_evaluated
+    constexpr inline bool
+    is_constant_evaluated() noexcept
+    { return __builtin_is_constant_evaluated(); }
+#endif
+
 } // namespace std
 #endif // C++20
 
@@ -28,11 +28,19 @@
 //
 // File version: 1.0.0
 //
-// Limitations:
-//  - std::visit support only one variant as argument
+// Features:
+//  - std::visit<R> from C++20
 //
-// Not implemented (yet):
-//  - std::hash<std::variant>
+// Configuration:
+//  - ARD_VARIANT_SWITCH_VISIT, see below
+//  - ARD_VARIANT_NEVER_VALUELESS, if defined, variant() constructs
+//    alternative 0 as the standard requires (it is valueless otherwise)
+//    and variant is never valueless. Exceptions are disabled, so there is
+//    no way to get there. valueless_by_exception() is constant false and
+//    the valueless checks in visit, get, comparisons, assignment and
+//    destruction are compiled out. Must be the same in all translation
+//    units. No effect in C++17, where <variant> is used. Rejected when
+//    exceptions are enabled.
 //
 
 #pragma once
@@ -43,12 +51,36 @@
 
 #include <tuple>
 #include <algorithm>
+#include <climits>
 
 #include "type_traits.hpp"
 #include "utility.hpp"
 #include "memory.hpp"
 #include "exception.hpp"
 
+#include <bits/enable_special_members.h>
+#include <bits/functional_hash.h>
+
+#if defined(ARD_VARIANT_NEVER_VALUELESS) && defined(__cpp_exceptions)
+#error "ARD_VARIANT_NEVER_VALUELESS requires exceptions disabled (-fno-exceptions)"
+#endif
+
+// Visitation strategy of std::visit, may be defined per translation unit
+// before including this file. Visits dispatching over at most this many
+// alternatives (the product of the sizes for multi-variant visit) use
+// a switch statement that lets the compiler inline the visitor. Larger
+// ones call through a table of function pointers. Define as 0 to always
+// use the table. The value is a template argument of visit, so units
+// with different settings get different instantiations. Special members,
+// comparisons and hash are shared by all units and always switch over
+// up to 16 alternatives.
+#ifndef ARD_VARIANT_SWITCH_VISIT
+#define ARD_VARIANT_SWITCH_VISIT 16
+#endif
+
+static_assert(ARD_VARIANT_SWITCH_VISIT <= 16,
+    "ARD_VARIANT_SWITCH_VISIT must not exceed 16");
+
 namespace std
 {
     template <class...>
@@ -79,6 +111,9 @@ namespace std
     // monostate
     struct monostate {};
 
+    [[noreturn]] void
+    __throw_bad_variant_access(const char* __what);
+
     // bad_variant_access
     struct bad_variant_access : std::exception
     {
@@ -93,7 +128,7 @@ namespace std
         // Must point to a string with static storage duration:
         const char* _M_reason = "bad variant access";
 
-        [[noreturn]] friend void __throw_bad_variant_access(const char* __what);
+        friend void __throw_bad_variant_access(const char* __what);
     };
 
     // Must only be called with a string literal
@@ -101,6 +136,16 @@ namespace std
     __throw_bad_variant_access(const char* __what)
     { ard::throw_exception(bad_variant_access(__what)); }
 
+    // Index of valueless variant reached dispatch
+    [[noreturn]] inline void
+    __throw_bad_variant_index() {
+#ifdef ARD_VARIANT_NEVER_VALUELESS
+        __builtin_unreachable();
+#else
+        __throw_bad_variant_access("__raw_idx_visit: variant is valueless");
+#endif
+    }
+
     [[noreturn]] inline void
     __throw_bad_variant_access(bool __valueless) {
         if (__valueless) [[__unlikely__]]
@@ -165,6 +210,13 @@ namespace std
                     decltype(__overload_set<_Types...>::_fun(std::declval<_Tp>()))::value;
             };
 
+            // Smallest unsigned type able to hold every index of _Np
+            // alternatives plus the valueless state (all bits set).
+            template <size_t _Np>
+            using __select_index = std::conditional_t<
+                (_Np < size_t(UCHAR_MAX)), unsigned char,
+                std::conditional_t<(_Np < size_t(USHRT_MAX)), unsigned short, size_t>>;
+
             // Chack _Tp is in_place_type_t or in_place_index_t
             template <class>
             struct __is_in_place_tag : std::false_type {};
@@ -196,9 +248,12 @@ namespace std
                 return std::forward<_Visitor>(__visitor)(std::integral_constant<size_t, _Np>{});
             }
 
+            // Table dispatch, one indirect call through an array of
+            // function pointers.
             template <class _Visitor, size_t... _Ind>
             constexpr decltype(auto)
-            __raw_idx_visit(size_t __index, _Visitor&& __visitor, std::index_sequence<_Ind...>)
+            __raw_idx_visit(size_t __index, _Visitor&& __visitor,
+                std::index_sequence<_Ind...>, std::false_type /* switch */)
             {
                 if (__index < sizeof...(_Ind)) {
                     using _Ret = decltype(__visitor(std::integral_constant<size_t, 0>{}));
@@ -207,7 +262,72 @@ namespace std
                     };
                     return __vtable[__index](std::forward<_Visitor>(__visitor));
                 }
-                __throw_bad_variant_access("__raw_idx_visit: variant is valueless");
+                __throw_bad_variant_index();
+            }
+
+            // Case of switch dispatch, unreachable past the last index
+            template <size_t _Np, class _Ret, class _Visitor>
+            constexpr _Ret
+            __raw_idx_visit_case(_Visitor&& __visitor, std::true_type) {
+                return std::forward<_Visitor>(__visitor)(std::integral_constant<size_t, _Np>{});
+            }
+
+            template <size_t _Np, class _Ret, class _Visitor>
+            [[noreturn]] _Ret
+            __raw_idx_visit_case(_Visitor&&, std::false_type)
+            { __builtin_unreachable(); }
+
+            // Switch dispatch, no function pointers so the visitor may be
+            // inlined into the caller.
+            template <class _Visitor, size_t... _Ind>
+            constexpr decltype(auto)
+            __raw_idx_visit(size_t __index, _Visitor&& __visitor,
+                std::index_sequence<_Ind...>, std::true_type /* switch */)
+            {
+                using _Ret = decltype(__visitor(std::integral_constant<size_t, 0>{}));
+                constexpr size_t __size = sizeof...(_Ind);
+
+                switch (__index) {
+#define _VARIANT_VISIT_CASE(_Np) \
+                case _Np: \
+                    return __raw_idx_visit_case<_Np, _Ret>( \
+                        std::forward<_Visitor>(__visitor), \
+                        std::bool_constant<(_Np < __size)>{});
+
+                _VARIANT_VISIT_CASE(0)
+                _VARIANT_VISIT_CASE(1)
+                _VARIANT_VISIT_CASE(2)
+                _VARIANT_VISIT_CASE(3)
+                _VARIANT_VISIT_CASE(4)
+                _VARIANT_VISIT_CASE(5)
+                _VARIANT_VISIT_CASE(6)
+                _VARIANT_VISIT_CASE(7)
+                _VARIANT_VISIT_CASE(8)
+                _VARIANT_VISIT_CASE(9)
+                _VARIANT_VISIT_CASE(10)
+                _VARIANT_VISIT_CASE(11)
+                _VARIANT_VISIT_CASE(12)
+                _VARIANT_VISIT_CASE(13)
+                _VARIANT_VISIT_CASE(14)
+                _VARIANT_VISIT_CASE(15)
+
+#undef _VARIANT_VISIT_CASE
+                }
+                __throw_bad_variant_index();
+            }
+
+            // Switch limit of dispatch in variant members, comparisons
+            // and hash. Not ARD_VARIANT_SWITCH_VISIT, which may differ
+            // between translation units while these functions may not.
+            constexpr size_t __member_switch = 16;
+
+            // Switch over at most _Switch alternatives, table otherwise
+            template <size_t _Switch = __member_switch, class _Visitor, size_t... _Ind>
+            constexpr decltype(auto)
+            __raw_idx_visit(size_t __index, _Visitor&& __visitor, std::index_sequence<_Ind...> __seq)
+            {
+                return __raw_idx_visit(__index, std::forward<_Visitor>(__visitor), __seq,
+                    std::bool_constant<(sizeof...(_Ind) <= _Switch)>{});
             }
 
             template <class _Visitor, class... _Types>
@@ -219,6 +339,72 @@ namespace std
                     std::make_index_sequence<sizeof...(_Types)>{});
             }
 
+            // Multi-variant visitation. The alternatives held by all visited
+            // variants are encoded into a single (row-major) flat index, so
+            // any combination is dispatched by one __raw_idx_visit call.
+            template <size_t... _Sizes>
+            constexpr size_t
+            __flat_size() {
+                const size_t __sizes[] = { 1, _Sizes... };
+                size_t __ret = 1;
+                for (size_t __n : __sizes)
+                    __ret *= __n;
+                return __ret;
+            }
+
+            constexpr size_t
+            __flat_index(size_t __acc)
+            { return __acc; }
+
+            template <class _Variant, class... _Rest>
+            constexpr size_t
+            __flat_index(size_t __acc, const _Variant& __variant, const _Rest&... __rest) {
+                return __flat_index(
+                    __acc * variant_size<_Variant>::value + __variant.index(), __rest...);
+            }
+
+            // Alternative index of the variant at __pos encoded in __flat
+            template <size_t... _Sizes>
+            constexpr size_t
+            __unflatten(size_t __flat, size_t __pos) {
+                const size_t __sizes[] = { _Sizes... };
+                for (size_t __i = sizeof...(_Sizes) - 1; __i > __pos; --__i)
+                    __flat /= __sizes[__i];
+                return __flat % __sizes[__pos];
+            }
+
+            constexpr bool
+            __any_valueless()
+            { return false; }
+
+            template <class _Variant, class... _Rest>
+            constexpr bool
+            __any_valueless(const _Variant& __variant, const _Rest&... __rest)
+            { return __variant.valueless_by_exception() || __any_valueless(__rest...); }
+
+            // Invoke visitor with the alternatives selected by _Flat
+            template <size_t _Flat, class _Visitor, class... _Variants, size_t... _Ip>
+            constexpr decltype(auto)
+            __visit_flat(std::index_sequence<_Ip...>,
+                _Visitor&& __visitor, _Variants&&... __variants)
+            {
+                return std::forward<_Visitor>(__visitor)(
+                    __raw_get<__unflatten<variant_size<std::remove_cvref_t<_Variants>>::value...>(
+                        _Flat, _Ip)>(std::forward<_Variants>(__variants))...);
+            }
+
+            // INVOKE<R>, result is implicitly converted to _Ret or
+            // discarded when _Ret is void
+            template <class _Ret, size_t _Flat, class... _Args>
+            constexpr std::enable_if_t<!std::is_void<_Ret>::value, _Ret>
+            __visit_flat_r(_Args&&... __args)
+            { return __visit_flat<_Flat>(std::forward<_Args>(__args)...); }
+
+            template <class _Ret, size_t _Flat, class... _Args>
+            constexpr std::enable_if_t<std::is_void<_Ret>::value>
+            __visit_flat_r(_Args&&... __args)
+            { static_cast<void>(__visit_flat<_Flat>(std::forward<_Args>(__args)...)); }
+
             // Destroy non-trivially destructible type
             template <class _Tp, bool = std::is_trivially_destructible<_Tp>::value>
             struct __destroy
@@ -230,11 +416,298 @@ namespace std
                 { std::destroy_at(__object_ptr); }
             };
 
+            // This class template manages construction/destruction of
+            // the contained value for a std::variant. It has no special
+            // members of its own, those are provided by _Variant_payload.
+            template <class... _Types>
+            struct _Variant_storage
+            {
+                static constexpr bool _S_trivial_dtor =
+                    std::conjunction<std::is_trivially_destructible<_Types>...>::value;
+
+                static constexpr bool _S_trivial_copy =
+                    std::conjunction<std::is_trivially_copy_constructible<_Types>...,
+                        std::is_trivially_copy_assignable<_Types>...>::value;
+
+                static constexpr bool _S_trivial_move =
+                    std::conjunction<std::is_trivially_move_constructible<_Types>...,
+                        std::is_trivially_move_assignable<_Types>...>::value;
+
+                template <size_t _Np>
+                using __to_type = variant_alternative_t<_Np, variant<_Types...>>;
+
+                // Value holder (union). Storage is aligned for the strictest
+                // alternative and followed by the narrowest index type that fits,
+                // so the index lands in what would otherwise be tail padding.
+                // Ex. variant<uint8_t, bool> is 2 bytes, variant<char[3], short> is 4.
+                using __index_type = __select_index<sizeof...(_Types)>;
+
+                alignas(std::max({ alignof(_Types)... }))
+                unsigned char _M_storage[std::max({ sizeof(_Types)... })];
+                __index_type _M_index = __index_type(variant_npos);
+
+#ifdef ARD_VARIANT_NEVER_VALUELESS
+                // Index is always one of alternatives, tell the compiler
+                // so that dispatch needs no range check.
+                constexpr size_t
+                _M_index_value() const {
+                    if (_M_index >= sizeof...(_Types))
+                        __builtin_unreachable();
+                    return _M_index;
+                }
+
+                static constexpr bool
+                _M_valueless()
+                { return false; }
+#else
+                // Valueless state is all bits set in __index_type, adding one
+                // wraps it to zero so it widens to variant_npos.
+                constexpr size_t
+                _M_index_value() const
+                { return size_t(__index_type(_M_index + 1)) - 1; }
+
+                constexpr bool
+                _M_valueless() const
+                { return _M_index == __index_type(variant_npos); }
+#endif
+
+                // Construct value by index
+                template <size_t _Np, class _Tp = __to_type<_Np>, class... _Args>
+                constexpr _Tp&
+                _M_construct(_Args&&... __args) {
+                    _Tp* __ret = ::new ((void*)_M_storage) _Tp(std::forward<_Args>(__args)...);
+                    _M_index = __index_type(_Np);
+                    return *__ret;
+                }
+
+                // Destruct if no valueless
+                constexpr void
+                _M_destruct() {
+                    if (!_S_trivial_dtor && !_M_valueless()) {
+                        __raw_idx_visit(_M_index_value(), [this](auto _Np) {
+                            using _Tp = __to_type<_Np>;
+                            __destroy<_Tp>{}((_Tp*)_M_storage);
+                        }, std::index_sequence_for<_Types...>{});
+                    }
+#ifndef ARD_VARIANT_NEVER_VALUELESS
+                    // Callers construct new value right after
+                    _M_index = __index_type(variant_npos);
+#endif
+                }
+
+                // Raw getters
+                template <size_t _Np, class _Tp = __to_type<_Np>>
+                const _Tp& _M_get() const& { return *(_Tp*)_M_storage; }
+
+                template <size_t _Np, class _Tp = __to_type<_Np>>
+                _Tp& _M_get() & { return *(_Tp*)_M_storage; }
+
+                template <size_t _Np, class _Tp = __to_type<_Np>>
+                const _Tp&& _M_get() const&&  { return std::move(*(_Tp*)_M_storage); }
+
+                template <size_t _Np, class _Tp = __to_type<_Np>>
+                _Tp&& _M_get() && { return std::move(*(_Tp*)_M_storage); }
+
+                // Used to perform non-trivial copy construction,
+                // *this is valueless.
+                constexpr void
+                _M_copy_construct(const _Variant_storage& __rhs) {
+                    if (!__rhs._M_valueless()) {
+                        __raw_idx_visit(__rhs._M_index_value(), [this, &__rhs](auto _Np) {
+                            _M_construct<_Np>(__rhs.template _M_get<_Np>());
+                        }, std::index_sequence_for<_Types...>{});
+                    }
+                }
+
+                // Used to perform non-trivial move construction,
+                // *this is valueless.
+                constexpr void
+                _M_move_construct(_Variant_storage&& __rhs) {
+                    if (!__rhs._M_valueless()) {
+                        __raw_idx_visit(__rhs._M_index_value(), [this, &__rhs](auto _Np) {
+                            _M_construct<_Np>(std::move(__rhs).template _M_get<_Np>());
+                        }, std::index_sequence_for<_Types...>{});
+                    }
+                }
+
+                // Used to perform non-trivial copy assignment.
+                constexpr void
+                _M_copy_assign(const _Variant_storage& __rhs)
+                {
+                    // Note, _M_destruct will destroy value only if not valueless
+                    if (__rhs._M_valueless()) {
+                        // If both *this and rhs are valueless by exception, do nothing.
+                        // Otherwise, if rhs is valueless, but *this is not, destroy
+                        // the value contained in *this and makes it valueless.
+                        _M_destruct();
+                    }
+                    else { // rhs contains a value
+                        __raw_idx_visit(__rhs._M_index_value(), [this, &__rhs](auto _Np) {
+                            // If rhs holds the same alternative as *this, assign the
+                            // value contained in rhs to the value contained in *this
+                            if (__rhs._M_index == _M_index)
+                                _M_get<_Np>() = __rhs.template _M_get<_Np>();
+                            else {
+                                // rhs and *this has different index
+                                _M_destruct();
+                                _M_construct<_Np>(__rhs.template _M_get<_Np>());
+                            }
+                        }, std::index_sequence_for<_Types...>{});
+                    }
+                }
+
+                // Used to perform non-trivial move assignment.
+                constexpr void
+                _M_move_assign(_Variant_storage&& __rhs)
+                {
+                    // Same as copy assignment but moves in value
+                    if (__rhs._M_valueless())
+                        _M_destruct();
+                    else { // rhs contains a value
+                        __raw_idx_visit(__rhs._M_index_value(), [this, &__rhs](auto _Np) {
+                            if (__rhs._M_index == _M_index)
+                                _M_get<_Np>() = std::move(__rhs).template _M_get<_Np>();
+                            else {
+                                // rhs and *this has different index
+                                _M_destruct();
+                                _M_construct<_Np>(std::move(__rhs).template _M_get<_Np>());
+                            }
+                        }, std::index_sequence_for<_Types...>{});
+                    }
+                }
+            };
+
+            // Class template that provides the special members of variant.
+            // Each of them is trivial (memcpy-able, no visitation) when it
+            // is trivial for every alternative.
+            template <class _Storage,
+                bool /*_HasTrivialDestructor*/ = _Storage::_S_trivial_dtor,
+                bool /*_HasTrivialCopy */ = _Storage::_S_trivial_copy,
+                bool /*_HasTrivialMove */ = _Storage::_S_trivial_move>
+            struct _Variant_payload;
+
+            // Payload for trivial copy/move/destroy.
+            template <class _Storage>
+            struct _Variant_payload<_Storage, true, true, true>
+            : _Storage
+            { };
+
+            // Payload with non-trivial copy construction/assignment.
+            template <class _Storage>
+            struct _Variant_payload<_Storage, true, false, true>
+            : _Storage
+            {
+                _Variant_payload() = default;
+                ~_Variant_payload() = default;
+                _Variant_payload(_Variant_payload&&) = default;
+                _Variant_payload& operator=(_Variant_payload&&) = default;
+
+                // Non-trivial copy construction.
+                constexpr
+                _Variant_payload(const _Variant_payload& __other)
+                { this->_M_copy_construct(__other); }
+
+                // Non-trivial copy assignment.
+                constexpr _Variant_payload&
+                operator=(const _Variant_payload& __other) {
+                    this->_M_copy_assign(__other);
+                    return *this;
+                }
+            };
+
+            // Payload with non-trivial move construction/assignment.
+            template <class _Storage>
+            struct _Variant_payload<_Storage, true, true, false>
+            : _Storage
+            {
+                _Variant_payload() = default;
+                ~_Variant_payload() = default;
+                _Variant_payload(const _Variant_payload&) = default;
+                _Variant_payload& operator=(const _Variant_payload&) = default;
+
+                // Non-trivial move construction.
+                constexpr
+                _Variant_payload(_Variant_payload&& __other)
+                { this->_M_move_construct(std::move(__other)); }
+
+                // Non-trivial move assignment.
+                constexpr _Variant_payload&
+                operator=(_Variant_payload&& __other) {
+                    this->_M_move_assign(std::move(__other));
+                    return *this;
+                }
+            };
+
+            // Payload with non-trivial copy and move.
+            template <class _Storage>
+            struct _Variant_payload<_Storage, true, false, false>
+            : _Storage
+            {
+                _Variant_payload() = default;
+                ~_Variant_payload() = default;
+
+                // Non-trivial copy construction.
+                constexpr
+                _Variant_payload(const _Variant_payload& __other)
+                { this->_M_copy_construct(__other); }
+
+                // Non-trivial move construction.
+                constexpr
+                _Variant_payload(_Variant_payload&& __other)
+                { this->_M_move_construct(std::move(__other)); }
+
+                // Non-trivial copy assignment.
+                constexpr _Variant_payload&
+                operator=(const _Variant_payload& __other) {
+                    this->_M_copy_assign(__other);
+                    return *this;
+                }
+
+                // Non-trivial move assignment.
+                constexpr _Variant_payload&
+                operator=(_Variant_payload&& __other) {
+                    this->_M_move_assign(std::move(__other));
+                    return *this;
+                }
+            };
+
+            // Payload with non-trivial destructor.
+            template <class _Storage, bool _Copy, bool _Move>
+            struct _Variant_payload<_Storage, false, _Copy, _Move>
+            : _Variant_payload<_Storage, true, false, false>
+            {
+                // Base class implements all the constructors and assignment operators
+                _Variant_payload() = default;
+                _Variant_payload(const _Variant_payload&) = default;
+                _Variant_payload(_Variant_payload&&) = default;
+                _Variant_payload& operator=(const _Variant_payload&) = default;
+                _Variant_payload& operator=(_Variant_payload&&) = default;
+
+                // Destructor needs to destroy the contained value
+                ~_Variant_payload() { this->_M_destruct(); }
+            };
+
         } // namespace __variant
     } // namespace __detail
 
     template <class... _Types>
-    struct variant {
+    struct variant
+    : private __detail::__variant::_Variant_payload<
+        __detail::__variant::_Variant_storage<_Types...>>,
+      private _Enable_copy_move<
+        // Copy constructor.
+        std::conjunction<std::is_copy_constructible<_Types>...>::value,
+        // Copy assignment.
+        std::conjunction<std::is_copy_constructible<_Types>...,
+            std::is_copy_assignable<_Types>...>::value,
+        // Move constructor.
+        std::conjunction<std::is_move_constructible<_Types>...>::value,
+        // Move assignment.
+        std::conjunction<std::is_move_constructible<_Types>...,
+            std::is_move_assignable<_Types>...>::value,
+        // Unique tag type.
+        variant<_Types...>>
+    {
     private:
         static_assert(sizeof...(_Types) > 0,
             "variant must have at least one alternative");
@@ -270,56 +743,28 @@ namespace std
         static constexpr bool __not_in_place_tag =
            !__detail::__variant::__is_in_place_tag<std::decay_t<_Tp>>::value;
 
-        // Construct value by index
-        template <size_t _Np, class _Tp = __to_type<_Np>, class... _Args>
-        constexpr _Tp&
-        _M_construct(_Args&&... __args) {
-            _Tp* __ret = ::new (_M_storage) _Tp(std::forward<_Args>(__args)...);
-            _M_index = _Np;
-            return *__ret;
-        }
-
-        // Destruct if no valueless
-        constexpr void
-        _M_destruct() {
-            if (_M_index != variant_npos) {
-                __detail::__variant::__raw_idx_visit([this](auto _Np) {
-                    using _Tp = __to_type<_Np>;
-                    __detail::__variant::__destroy<_Tp>{}((_Tp*)_M_storage);
-                }, *this);
-                _M_index = variant_npos;
-            }
-        }
-
-        // Raw getters
-        template <size_t _Np, class _Tp = __to_type<_Np>>
-        const _Tp& _M_get() const& { return *(_Tp*)_M_storage; }
-
-        template <size_t _Np, class _Tp = __to_type<_Np>>
-        _Tp& _M_get() & { return *(_Tp*)_M_storage; }
-
-        template <size_t _Np, class _Tp = __to_type<_Np>>
-        const _Tp&& _M_get() const&&  { return std::move(*(_Tp*)_M_storage); }
-
-        template <size_t _Np, class _Tp = __to_type<_Np>>
-        _Tp&& _M_get() && { return std::move(*(_Tp*)_M_storage); }
-
         // External getter
         template <size_t, class _Variant>
         friend constexpr decltype(auto) __detail::__variant::__raw_get(_Variant&&);
 
-        // Value holder (union)
-        unsigned char _M_storage[std::max({ sizeof(_Types)... })];
-        size_t _M_index = variant_npos;
-
     public:
         // Constructors
         // 1
+#ifdef ARD_VARIANT_NEVER_VALUELESS
+        template <class _Tp = __to_type<0>,
+            class = std::enable_if_t<std::is_default_constructible<_Tp>::value>
+        >
+        constexpr
+        variant() noexcept(std::is_nothrow_default_constructible<_Tp>::value)
+        : variant(std::in_place_index_t<0>{})
+        { }
+#else
         constexpr variant() = default;
+#endif
         // 2
-        constexpr variant(const variant& __rhs);
+        constexpr variant(const variant& __rhs) = default;
         // 3
-        constexpr variant(variant&& __rhs);
+        constexpr variant(variant&& __rhs) = default;
 
         // 4
         template <class _Tp,
@@ -362,7 +807,7 @@ namespace std
         >
         constexpr explicit
         variant(std::in_place_index_t<_Np>, _Args&&... __args)
-        { _M_construct<_Np, _Tp>(std::forward<_Args>(__args)...); }
+        { this->template _M_construct<_Np, _Tp>(std::forward<_Args>(__args)...); }
 
         // 8
         template <size_t _Np, class _Up, class... _Args,
@@ -373,17 +818,15 @@ namespace std
         constexpr explicit
         variant(std::in_place_index_t<_Np>,
             std::initializer_list<_Up> __il, _Args&&... __args)
-        { _M_construct<_Np, _Tp>(__il, std::forward<_Args>(__args)...); }
+        { this->template _M_construct<_Np, _Tp>(__il, std::forward<_Args>(__args)...); }
 
-        // Destructor
-        ~variant()
-        { _M_destruct(); }
+        // Destructor is implicit, implemented in _Variant_payload.
 
         // Assignments
         // 1
-        constexpr variant& operator=(const variant& __rhs);
+        constexpr variant& operator=(const variant& __rhs) = default;
         // 2
-        constexpr variant& operator=(variant&& __rhs);
+        constexpr variant& operator=(variant&& __rhs) = default;
 
         // 3
         template <class _Tp,
@@ -395,11 +838,11 @@ namespace std
         >
         constexpr variant&
         operator=(_Tp&& __rhs) {
-            if (_M_index == _Np)
-                _M_get<_Np, _Tj>() = std::forward<_Tp>(__rhs);
+            if (index() == _Np)
+                this->template _M_get<_Np, _Tj>() = std::forward<_Tp>(__rhs);
             else {
-                _M_destruct();
-                _M_construct<_Np, _Tj>(std::forward<_Tp>(__rhs));
+                this->_M_destruct();
+                this->template _M_construct<_Np, _Tj>(std::forward<_Tp>(__rhs));
             }
             return *this;
         }
@@ -430,8 +873,8 @@ namespace std
         >
         constexpr variant_alternative_t<_Np, variant>&
         emplace(_Args&&... __args) {
-            _M_destruct();
-            return _M_construct<_Np>(std::forward<_Args>(__args)...);
+            this->_M_destruct();
+            return this->template _M_construct<_Np>(std::forward<_Args>(__args)...);
         }
 
         // 4
@@ -442,8 +885,8 @@ namespace std
         >
         variant_alternative_t<_Np, variant>&
         emplace(std::initializer_list<_Up> __il, _Args&&... __args) {
-            _M_destruct();
-            return _M_construct<_Np>(__il, std::forward<_Args>(__args)...);
+            this->_M_destruct();
+            return this->template _M_construct<_Np>(__il, std::forward<_Args>(__args)...);
         }
 
         // Swap
@@ -452,11 +895,17 @@ namespace std
 
         // Returns the zero-based index of the alternative held by the variant
         constexpr size_t index() const
-        { return _M_index; }
+        { return this->_M_index_value(); }
 
         // Returns false if and only if the variant holds a value
+#ifdef ARD_VARIANT_NEVER_VALUELESS
+        // vlta: static, so that it can be checked at compile time
+        static constexpr bool valueless_by_exception()
+        { return false; }
+#else
         constexpr bool valueless_by_exception() const
-        { return _M_index == variant_npos; }
+        { return this->_M_valueless(); }
+#endif
     };
 
     // get
@@ -559,105 +1008,45 @@ namespace std
         return __v.index() == __detail::__variant::__index_of<_Tp, _Types...>::value;
     }
 
-    // visit
-    // Support only one variant for now
-    template <class _Visitor, class _Variant>
+    // visit, _Switch is taken from the including translation unit
+    template <class _Visitor, class... _Variants,
+        size_t _Switch = ARD_VARIANT_SWITCH_VISIT>
     constexpr decltype(auto)
-    visit(_Visitor&& __visitor, _Variant&& __variant)
+    visit(_Visitor&& __visitor, _Variants&&... __variants)
     {
-        if (__variant.valueless_by_exception())
+        if (__detail::__variant::__any_valueless(__variants...))
             __throw_bad_variant_access("std::visit: variant is valueless");
 
-        return __detail::__variant::__raw_idx_visit(
-            [&](auto _Np) -> decltype(auto) {
-                return std::forward<_Visitor>(__visitor)(
-                    __detail::__variant::__raw_get<_Np>(std::forward<_Variant>(__variant)));
+        return __detail::__variant::__raw_idx_visit<_Switch>(
+            __detail::__variant::__flat_index(0, __variants...),
+            [&](auto _Flat) -> decltype(auto) {
+                return __detail::__variant::__visit_flat<_Flat>(
+                    std::index_sequence_for<_Variants...>{},
+                    std::forward<_Visitor>(__visitor),
+                    std::forward<_Variants>(__variants)...);
             },
-            std::forward<_Variant>(__variant));
-    }
-
-    // Constructors
-    // 2
-    template <class... _Types>
-    constexpr
-    variant<_Types...>::variant(const variant<_Types...>& __rhs)
-    {
-        if (!__rhs.valueless_by_exception()) {
-            __detail::__variant::__raw_idx_visit(
-                [this, &__rhs](auto _Np) {
-                    _M_construct<_Np>(__rhs.template _M_get<_Np>());
-                },
-                __rhs);
-        }
-    }
-
-    // 3
-    template <class... _Types>
-    constexpr
-    variant<_Types...>::variant(variant<_Types...>&& __rhs)
-    {
-        if (!__rhs.valueless_by_exception()) {
-            __detail::__variant::__raw_idx_visit(
-                [this, &__rhs](auto _Np) {
-                    _M_construct<_Np>(std::move(__rhs).template _M_get<_Np>());
-                },
-                __rhs);
-        }
+            std::make_index_sequence<__detail::__variant::__flat_size<
+                variant_size<std::remove_cvref_t<_Variants>>::value...>()>{});
     }
 
-    // Assignments
-    // 1
-    template <class... _Types>
-    constexpr variant<_Types...>&
-    variant<_Types...>::operator=(const variant<_Types...>& __rhs)
+    template <class _Ret, class _Visitor, class... _Variants,
+        size_t _Switch = ARD_VARIANT_SWITCH_VISIT>
+    constexpr _Ret
+    visit(_Visitor&& __visitor, _Variants&&... __variants)
     {
-        // Note, _M_destruct will destroy value only if not valueless
-        if (__rhs.valueless_by_exception()) {
-            // If both *this and rhs are valueless by exception, do nothing.
-            // Otherwise, if rhs is valueless, but *this is not, destroy
-            // the value contained in *this and makes it valueless.
-            _M_destruct();
-        }
-        else { // rhs contains a value
-            __detail::__variant::__raw_idx_visit(
-                [this, &__rhs](auto _Np) {
-                    // If rhs holds the same alternative as *this, assign the
-                    // value contained in rhs to the value contained in *this
-                    if (__rhs._M_index == _M_index)
-                        _M_get<_Np>() = __rhs.template _M_get<_Np>();
-                    else {
-                        // rhs and *this has different index
-                        _M_destruct();
-                        _M_construct<_Np>(__rhs.template _M_get<_Np>());
-                    }
-                },
-                __rhs);
-        }
-        return *this;
-    }
+        if (__detail::__variant::__any_valueless(__variants...))
+            __throw_bad_variant_access("std::visit: variant is valueless");
 
-    // 2
-    template <class... _Types>
-    constexpr variant<_Types...>&
-    variant<_Types...>::operator=(variant<_Types...>&& __rhs)
-    {
-        // Same as copy assignment but moves in value
-        if (__rhs.valueless_by_exception())
-            _M_destruct();
-        else { // rhs contains a value
-            __detail::__variant::__raw_idx_visit(
-                [this, &__rhs](auto _Np) {
-                    if (__rhs._M_index == _M_index)
-                        _M_get<_Np>() = std::move(__rhs).template _M_get<_Np>();
-                    else {
-                        // rhs and *this has different index
-                        _M_destruct();
-                        _M_construct<_Np>(std::move(__rhs).template _M_get<_Np>());
-                    }
-                },
-                __rhs);
-        }
-        return *this;
+        return __detail::__variant::__raw_idx_visit<_Switch>(
+            __detail::__variant::__flat_index(0, __variants...),
+            [&](auto _Flat) -> _Ret {
+                return __detail::__variant::__visit_flat_r<_Ret, _Flat>(
+                    std::index_sequence_for<_Variants...>{},
+                    std::forward<_Visitor>(__visitor),
+                    std::forward<_Variants>(__variants)...);
+            },
+            std::make_index_sequence<__detail::__variant::__flat_size<
+                variant_size<std::remove_cvref_t<_Variants>>::value...>()>{});
     }
 
     // Swap
@@ -665,17 +1054,44 @@ namespace std
     constexpr void
     variant<_Types...>::swap(variant<_Types...>& __rhs)
     {
+        using _Storage = __detail::__variant::_Variant_storage<_Types...>;
+
         // If both *this and rhs are valueless by exception, do nothing.
         if (valueless_by_exception() && __rhs.valueless_by_exception())
             return;
-        // Note! Just swapping _M_storage and _M_index do not always work.
-        // Ex. std::string that hold a pointer to internal buffer (small
-        // string optimization) and will still point to old buffer.
-        // Now we could visit both indexes here, but it would be almost
-        // the same code as traditional swap. So do traditional one.
-        variant _tmp(std::move(__rhs));
-        __rhs = std::move(*this);
-        *this = std::move(_tmp);
+
+        if (index() == __rhs.index()) {
+            // Same alternative, use its own swap
+            __detail::__variant::__raw_idx_visit([this, &__rhs](auto _Np) {
+                using std::swap;
+                swap(this->template _M_get<_Np>(), __rhs.template _M_get<_Np>());
+            }, *this);
+        }
+        // Different alternatives, trivially copyable ones can be swapped
+        // as raw bytes. Note! It does not work for others. Ex. std::string
+        // that hold a pointer to internal buffer (small string optimization)
+        // and will still point to old buffer.
+        else if (std::conjunction<std::is_trivially_copyable<_Types>...>::value)
+            std::swap(static_cast<_Storage&>(*this), static_cast<_Storage&>(__rhs));
+        else if (valueless_by_exception()) {
+            this->_M_move_construct(std::move(__rhs));
+            __rhs._M_destruct();
+        }
+        else if (__rhs.valueless_by_exception()) {
+            __rhs._M_move_construct(std::move(*this));
+            this->_M_destruct();
+        }
+        else {
+            // Different alternatives, set rhs value aside and move
+            // each value straight across
+            __detail::__variant::__raw_idx_visit([this, &__rhs](auto _Np) {
+                auto __tmp(std::move(__rhs).template _M_get<_Np>());
+                __rhs._M_destruct();
+                __rhs._M_move_construct(std::move(*this));
+                this->_M_destruct();
+                this->template _M_construct<_Np>(std::move(__tmp));
+            }, __rhs);
+        }
     }
 
     template <class... _Types>
@@ -706,7 +1122,7 @@ namespace std
     constexpr bool operator __OP( \
         const std::variant<_Types...>& __lhs, const std::variant<_Types...>& __rhs) \
     { \
-        if (__rhs.index() != variant_npos) { \
+        if (!__rhs.valueless_by_exception()) { \
             if (__lhs.index() == __rhs.index()) { \
                 return __detail::__variant::__raw_idx_visit( \
                     [&](auto _Np) { \
@@ -727,6 +1143,83 @@ namespace std
 
 #undef _VARIANT_RELATION_FUNCTION_TEMPLATE
 
+    // hash support
+    template <>
+    struct hash<monostate>
+    {
+        using result_type = size_t;
+        using argument_type = monostate;
+
+        size_t
+        operator()(const monostate&) const noexcept
+        {
+            constexpr size_t __magic_monostate_hash = -7777;
+            return __magic_monostate_hash;
+        }
+    };
+
+    namespace __detail {
+        namespace __variant
+        {
+            // Poisons hash<variant> unless every alternative is hashable.
+            // Base classes are tagged with index since alternatives may repeat.
+            template <size_t _Np, class _Tp>
+            struct _Base_dedup : _Tp {};
+
+            template <class _Variant, class _Indices>
+            struct _Variant_hash_base;
+
+            template <class _Variant, size_t... _Ind>
+            struct _Variant_hash_base<_Variant, std::index_sequence<_Ind...>>
+            : _Base_dedup<_Ind,
+                __poison_hash<std::remove_const_t<variant_alternative_t<_Ind, _Variant>>>>...
+            { };
+
+            template <bool, class... _Types>
+            struct __variant_hash_call_base_impl
+            {
+                size_t
+                operator()(const variant<_Types...>& __t) const
+                noexcept(std::conjunction<std::is_nothrow_invocable<
+                    hash<std::remove_const_t<_Types>>, const _Types&>...>::value)
+                {
+                    if (__t.valueless_by_exception())
+                        return hash<size_t>{}(__t.index());
+
+                    return __raw_idx_visit([&__t](auto _Np) {
+                        using _Tp = std::remove_const_t<variant_alternative_t<_Np, variant<_Types...>>>;
+                        return hash<size_t>{}(__t.index()) + hash<_Tp>{}(__raw_get<_Np>(__t));
+                    }, __t);
+                }
+            };
+
+            template <class... _Types>
+            struct __variant_hash_call_base_impl<false, _Types...> {};
+
+            template <class... _Types>
+            using __variant_hash_call_base = __variant_hash_call_base_impl<
+                std::conjunction<std::bool_constant<
+                    __poison_hash<std::remove_const_t<_Types>>::__enable_hash_call>...>::value,
+                _Types...>;
+
+        } // namespace __variant
+    } // namespace __detail
+
+    template <class... _Types>
+    struct hash<variant<_Types...>>
+    : private __detail::__variant::_Variant_hash_base<
+        variant<_Types...>, std::index_sequence_for<_Types...>>,
+      public __detail::__variant::__variant_hash_call_base<_Types...>
+    {
+        using result_type = size_t;
+        using argument_type = variant<_Types...>;
+    };
+
+    template <class... _Types>
+    struct __is_fast_hash<hash<variant<_Types...>>>
+    : std::conjunction<__is_fast_hash<hash<std::remove_const_t<_Types>>>...>
+    { };
+
 } // namespace std
 
 #endif // __cplusplus < 201703L
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+#
+# Decode error codes thrown with ARD_ERROR_CODES defined
+# Vladimir Talybin (2021)
+#
+# Usage:
+#   decode_error.py CODE [LINE]
+#   decode_error.py < device.log
+#
+# Without arguments, reads text from stdin and expands every
+# "ard::error E<code> L<line>" found into the original message.
+#
+
+import os
+import re
+import sys
+
+SRC = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'src')
+
+ENUM_RE = re.compile(r'^\s*(\w+)\s*=\s*(\d+)\s*,\s*//\s*(.*?)\s*$')
+ERROR_RE = re.compile(r'ard::error E(\d+) L(\d+)')
+
+
+def load_codes():
+    """Map code to (name, message) from error_code in exception.hpp"""
+    codes = {}
+    in_enum = False
+    with open(os.path.join(SRC, 'exception.hpp')) as f:
+        for line in f:
+            if 'enum class error_code' in line:
+                in_enum = True
+            elif in_enum:
+                if '};' in line:
+                    break
+                m = ENUM_RE.match(line)
+                if m:
+                    codes[int(m.group(2))] = (m.group(1), m.group(3))
+    return codes
+
+
+def find_file(name):
+    """Header throwing error with given name"""
+    use = 'ARD_THROW_ERROR(' + name + ','
+    for fn in sorted(os.listdir(SRC)):
+        if fn.endswith('.hpp'):
+            with open(os.path.join(SRC, fn)) as f:
+                if use in f.read():
+                    return fn
+    return '?'
+
+
+def decode(codes, code, line=None):
+    if code not in codes:
+        return 'unknown error code %d' % code
+    name, msg = codes[code]
+    where = find_file(name)
+    if line is not None:
+        where += ':%d' % line
+    return '%s (%s)' % (msg, where)
+
+
+def main(argv):
+    codes = load_codes()
+    if len(argv) > 1:
+        line = int(argv[2]) if len(argv) > 2 else None
+        print(decode(codes, int(argv[1]), line))
+        return 0
+    for text in sys.stdin:
+        sys.stdout.write(ERROR_RE.sub(
+            lambda m: decode(codes, int(m.group(1)), int(m.group(2))), text))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))